@@ -0,0 +1,86 @@
+# Writes a C++ source that compiles bible_sections.bin into the program as
+# read-only data and defines the accessors declared in src/EmbeddedCorpus.h.
+# Run as: cmake -DINPUT=bible_sections.bin -DOUTPUT=EmbeddedCorpus.cpp -DMODE=incbin|array -P EmbedCorpus.cmake
+#
+# incbin (GCC, Clang) has the assembler copy the file, so compile time does
+# not depend on its size. array (MSVC, which has no top-level asm) spells the
+# bytes out as an initializer.
+
+if(NOT INPUT OR NOT OUTPUT OR NOT MODE)
+    message(FATAL_ERROR "EmbedCorpus.cmake needs -DINPUT=..., -DOUTPUT=... and -DMODE=...")
+endif()
+if(NOT EXISTS "${INPUT}")
+    message(FATAL_ERROR "EmbedCorpus.cmake: ${INPUT} does not exist")
+endif()
+
+set(header "// Generated by cmake/EmbedCorpus.cmake from ${INPUT}; do not edit.\n\n#include \"EmbeddedCorpus.h\"\n\n")
+
+if(MODE STREQUAL "incbin")
+    file(TO_CMAKE_PATH "${INPUT}" input)
+    file(WRITE "${OUTPUT}" "${header}"
+"#define BIBIRBLE_STR2(x) #x
+#define BIBIRBLE_STR(x) BIBIRBLE_STR2(x)
+#define BIBIRBLE_SYMBOL(name) BIBIRBLE_STR(__USER_LABEL_PREFIX__) #name
+
+#if defined(__APPLE__)
+#  define BIBIRBLE_PUSH_SECTION \".const_data\\n\"
+#  define BIBIRBLE_POP_SECTION \".text\\n\"
+#elif defined(_WIN32)
+#  define BIBIRBLE_PUSH_SECTION \".pushsection .rdata,\\\"dr\\\"\\n\"
+#  define BIBIRBLE_POP_SECTION \".popsection\\n\"
+#else
+#  define BIBIRBLE_PUSH_SECTION \".pushsection .rodata,\\\"a\\\"\\n\"
+#  define BIBIRBLE_POP_SECTION \".popsection\\n\"
+#endif
+
+// 64-byte alignment keeps every section of the image aligned for its type.
+__asm__(
+    BIBIRBLE_PUSH_SECTION
+    \".balign 64\\n\"
+    \".globl \" BIBIRBLE_SYMBOL(bibirble_corpus_begin) \"\\n\"
+    \".globl \" BIBIRBLE_SYMBOL(bibirble_corpus_end) \"\\n\"
+    BIBIRBLE_SYMBOL(bibirble_corpus_begin) \":\\n\"
+    \".incbin \\\"${input}\\\"\\n\"
+    BIBIRBLE_SYMBOL(bibirble_corpus_end) \":\\n\"
+    \".byte 0\\n\"
+    BIBIRBLE_POP_SECTION
+);
+
+extern \"C\" const unsigned char bibirble_corpus_begin[];
+extern \"C\" const unsigned char bibirble_corpus_end[];
+
+const unsigned char* EmbeddedCorpusData() {
+    return bibirble_corpus_begin;
+}
+
+std::size_t EmbeddedCorpusSize() {
+    return static_cast<std::size_t>(bibirble_corpus_end - bibirble_corpus_begin);
+}
+")
+elseif(MODE STREQUAL "array")
+    file(SIZE "${INPUT}" size)
+    file(READ "${INPUT}" hex HEX)
+    # 32 bytes per line, then each byte as 0xNN.
+    string(REPEAT "[0-9a-f]" 64 line)
+    string(REGEX REPLACE "(${line})" "\\1\n" hex "${hex}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+    file(WRITE "${OUTPUT}" "${header}"
+"namespace {
+
+alignas(64) const unsigned char kCorpus[${size}] = {
+${bytes}
+};
+
+}
+
+const unsigned char* EmbeddedCorpusData() {
+    return kCorpus;
+}
+
+std::size_t EmbeddedCorpusSize() {
+    return sizeof(kCorpus);
+}
+")
+else()
+    message(FATAL_ERROR "EmbedCorpus.cmake: MODE must be incbin or array, not '${MODE}'")
+endif()
@@ -0,0 +1,60 @@
+# Writes the constexpr book table included by src/BookTable.h from
+# tools/books.tsv. Run as: cmake -DINPUT=books.tsv -DOUTPUT=BookTableData.h -P GenerateBookTable.cmake
+
+if(NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "GenerateBookTable.cmake needs -DINPUT=... and -DOUTPUT=...")
+endif()
+
+file(STRINGS "${INPUT}" lines ENCODING UTF-8)
+set(testaments "")
+set(areas "")
+set(rows "")
+set(count 0)
+foreach(line IN LISTS lines)
+    if(line STREQUAL "" OR line MATCHES "^#")
+        continue()
+    endif()
+    string(REPLACE "\t" ";" fields "${line}")
+    list(LENGTH fields fieldCount)
+    if(NOT fieldCount EQUAL 6)
+        message(FATAL_ERROR "${INPUT}: expected 6 tab-separated fields in '${line}'")
+    endif()
+    list(GET fields 0 name)
+    list(GET fields 1 display)
+    list(GET fields 2 testament)
+    list(GET fields 3 area)
+    list(GET fields 4 familiarity)
+    list(GET fields 5 chapters)
+    if(NOT name MATCHES "^[0-9a-z]+$" OR NOT familiarity MATCHES "^[012]$" OR NOT chapters MATCHES "^[1-9][0-9]*$")
+        message(FATAL_ERROR "${INPUT}: malformed row '${line}'")
+    endif()
+
+    # Testaments and areas are numbered in order of first appearance.
+    list(FIND testaments "${testament}" testamentId)
+    if(testamentId EQUAL -1)
+        list(LENGTH testaments testamentId)
+        list(APPEND testaments "${testament}")
+    endif()
+    list(FIND areas "${area}" areaId)
+    if(areaId EQUAL -1)
+        list(LENGTH areas areaId)
+        list(APPEND areas "${area}")
+    endif()
+    string(APPEND rows "    {\"${name}\", \"${display}\", ${testamentId}, ${areaId}, ${familiarity}, ${chapters}},\n")
+    math(EXPR count "${count} + 1")
+endforeach()
+
+set(text "// Generated from tools/books.tsv by cmake/GenerateBookTable.cmake; do not edit.\n")
+string(APPEND text "// Included by BookTable.h.\n\n")
+string(APPEND text "constexpr std::string_view kTestamentNames[] = {\n")
+foreach(testament IN LISTS testaments)
+    string(APPEND text "    \"${testament}\",\n")
+endforeach()
+string(APPEND text "};\n\nconstexpr std::string_view kAreaNames[] = {\n")
+foreach(area IN LISTS areas)
+    string(APPEND text "    \"${area}\",\n")
+endforeach()
+string(APPEND text "};\n\n// name, display name, testament, area, familiarity, chapters\n")
+string(APPEND text "constexpr BookInfo kBooks[${count}] = {\n${rows}};\n")
+
+file(WRITE "${OUTPUT}" "${text}")
@@ -0,0 +1,47 @@
+#include "AliasTable.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool AliasTable::build(const std::vector<double>& weights) {
+    clear();
+    const std::size_t n = weights.size();
+    double total = 0.0;
+    for (const double w : weights) {
+        if (w > 0.0) total += w;
+    }
+    if (n == 0 || !(total > 0.0)) return false;
+
+    // Scale so the average column holds exactly 1, then pair each column
+    // below 1 with one above it that tops it up.
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (std::size_t i = 0; i < n; ++i) {
+        scaled[i] = weights[i] > 0.0 ? weights[i] * n / total : 0.0;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    m_threshold.assign(n, std::numeric_limits<uint32_t>::max());
+    m_alias.resize(n);
+    for (std::size_t i = 0; i < n; ++i) m_alias[i] = static_cast<uint32_t>(i);
+
+    while (!small.empty() && !large.empty()) {
+        const uint32_t lo = small.back();
+        small.pop_back();
+        const uint32_t hi = large.back();
+        m_threshold[lo] = static_cast<uint32_t>(std::ldexp(std::max(scaled[lo], 0.0), 32));
+        m_alias[lo] = hi;
+        scaled[hi] -= 1.0 - scaled[lo];
+        if (scaled[hi] < 1.0) {
+            large.pop_back();
+            small.push_back(hi);
+        }
+    }
+    // Whatever is left is 1 up to rounding error and always keeps itself.
+    return true;
+}
+
+void AliasTable::clear() {
+    m_threshold.clear();
+    m_alias.clear();
+}
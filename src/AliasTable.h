@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Walker's alias method (Vose's construction): after an O(n) build, draws
+// index i with probability weights[i] / sum(weights) from a single 64-bit
+// random number, whatever the distribution.
+class AliasTable {
+public:
+    // Returns false, leaving the table empty, if there is no positive weight.
+    bool build(const std::vector<double>& weights);
+    void clear();
+    bool empty() const { return m_threshold.empty(); }
+    std::size_t size() const { return m_threshold.size(); }
+
+    std::size_t sample(std::mt19937_64& rng) const {
+        const uint64_t r = rng();
+        // High half picks a column (multiply-shift, no division), low half
+        // decides between the column and its alias.
+        const std::size_t column = static_cast<std::size_t>(((r >> 32) * m_threshold.size()) >> 32);
+        return static_cast<uint32_t>(r) < m_threshold[column] ? column : m_alias[column];
+    }
+
+private:
+    // Probability of keeping each column, scaled to 2^32.
+    std::vector<uint32_t> m_threshold;
+    std::vector<uint32_t> m_alias;
+};
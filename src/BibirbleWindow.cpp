@@ -1,26 +1,40 @@
 #include "BibirbleWindow.h"
+#include "Trace.h"
 #include <wx/msgdlg.h>
 #include <wx/scrolwin.h>
 #include <wx/clipbrd.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
 #include <algorithm>
+#include <random>
+#include <utility>
+
+namespace {
+
+wxString ToWx(std::string_view text) {
+    return wxString::FromUTF8(text.data(), text.size());
+}
+
+}
 
 wxBEGIN_EVENT_TABLE(BibirbleWindow, wxFrame)
     EVT_BUTTON(wxID_OK, BibirbleWindow::OnSubmit)
 wxEND_EVENT_TABLE()
 
-BibirbleWindow::BibirbleWindow(wxWindow* parent, const std::string& dataPath)
-    : wxFrame(parent, wxID_ANY, "Bibirble", wxDefaultPosition, wxSize(500, 850)) {
+BibirbleWindow::BibirbleWindow(wxWindow* parent, BibleData data)
+    : wxFrame(parent, wxID_ANY, "Bibirble", wxDefaultPosition, wxSize(500, 850)),
+      m_data(std::move(data)),
+      m_engine(m_data),
+      m_daily(m_data.verseCount()) {
 
-    const std::string resolvedPath = dataPath.empty()
-        ? BibleData::ResolveDataFilePath("bible_sections.json")
-        : dataPath;
-    m_data.loadData(resolvedPath);
     SetupUi();
+    SetupUserData();
     StartNewGame();
 }
 
 
 void BibirbleWindow::SetupUi() {
+    TRACE_SCOPE("BibirbleWindow::SetupUi");
     wxColour bgColor(234, 229, 159);  // #eae59f
     
     m_centralPanel = new wxPanel(this);
@@ -37,6 +51,24 @@ void BibirbleWindow::SetupUi() {
     
     wxStaticText* subtitle = new wxStaticText(m_centralPanel, wxID_ANY, "World English Bible Version");
     mainLayout->Add(subtitle, 0, wxALL | wxALIGN_CENTER, 5);
+
+    // Order matches the Difficulty enum
+    wxArrayString tiers;
+    tiers.Add("Easy");
+    tiers.Add("Normal");
+    tiers.Add("Hard");
+    m_difficultyChoice = new wxChoice(m_centralPanel, wxID_ANY, wxDefaultPosition, wxDefaultSize, tiers);
+    m_difficultyChoice->SetSelection(static_cast<int>(Difficulty::Normal));
+    m_difficultyChoice->Bind(wxEVT_CHOICE, &BibirbleWindow::OnDifficulty, this);
+    m_dailyBtn = new wxButton(m_centralPanel, wxID_ANY, "Daily Verse");
+    m_dailyBtn->Bind(wxEVT_BUTTON, &BibirbleWindow::OnDaily, this);
+    wxBoxSizer* modeLayout = new wxBoxSizer(wxHORIZONTAL);
+    modeLayout->Add(m_difficultyChoice, 0, wxALL | wxALIGN_CENTER_VERTICAL, 5);
+    modeLayout->Add(m_dailyBtn, 0, wxALL | wxALIGN_CENTER_VERTICAL, 5);
+    m_statsBtn = new wxButton(m_centralPanel, wxID_ANY, "Statistics");
+    m_statsBtn->Bind(wxEVT_BUTTON, &BibirbleWindow::OnStats, this);
+    modeLayout->Add(m_statsBtn, 0, wxALL | wxALIGN_CENTER_VERTICAL, 5);
+    mainLayout->Add(modeLayout, 0, wxALIGN_CENTER);
     
     // Reveal Panel
     m_revealPanel = new wxStaticText(m_centralPanel, wxID_ANY, "Loading...");
@@ -45,6 +77,9 @@ void BibirbleWindow::SetupUi() {
     m_revealPanel->Wrap(400);
     mainLayout->Add(m_revealPanel, 0, wxALL | wxEXPAND, 10);
     
+    m_remainingLabel = new wxStaticText(m_centralPanel, wxID_ANY, "");
+    mainLayout->Add(m_remainingLabel, 0, wxLEFT | wxRIGHT | wxALIGN_CENTER, 10);
+    
     // Scroll Area for Game Rows
     wxScrolledWindow* scrollArea = new wxScrolledWindow(m_centralPanel);
     scrollArea->SetScrollRate(5, 5);
@@ -53,16 +88,10 @@ void BibirbleWindow::SetupUi() {
     m_rowsSizer = new wxBoxSizer(wxVERTICAL);
     scrollArea->SetSizer(m_rowsSizer);
     
-    // 7 Game Rows
-    wxArrayString books;
-    std::vector<std::string> bookList = m_data.getAllBooks();
-    std::sort(bookList.begin(), bookList.end());
-    for (const auto& book : bookList) {
-        books.Add(book);
-    }
-    
-    for (int i = 0; i < 7; ++i) {
-        GameRow* row = new GameRow(scrollArea, books);
+    // One row per allowed guess, all sharing one book list
+    m_bookChoices.reset(new BookChoices(m_data));
+    for (int i = 0; i < GameEngine::kMaxGuesses; ++i) {
+        GameRow* row = new GameRow(scrollArea, *m_bookChoices, m_data);
         m_rowsSizer->Add(row, 0, wxEXPAND | wxALL, 5);
         m_rows.push_back(row);
     }
@@ -89,6 +118,10 @@ void BibirbleWindow::SetupUi() {
     m_submitBtn->SetFont(btnFont);
     Bind(wxEVT_BUTTON, &BibirbleWindow::OnSubmit, this, wxID_OK);
     m_rowsSizer->Add(m_submitBtn, 0, wxEXPAND | wxALL, 10);
+
+    m_hintBtn = new wxButton(scrollArea, wxID_ANY, "Hint");
+    m_hintBtn->Bind(wxEVT_BUTTON, &BibirbleWindow::OnHint, this);
+    m_rowsSizer->Add(m_hintBtn, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 10);
     
     mainLayout->Add(scrollArea, 1, wxEXPAND);
     
@@ -100,6 +133,7 @@ void BibirbleWindow::SetupUi() {
 
 
 void BibirbleWindow::SetupKeyboard(wxBoxSizer* parentLayout) {
+    TRACE_SCOPE("BibirbleWindow::SetupKeyboard");
     wxPanel* kbPanel = new wxPanel(m_centralPanel);
     kbPanel->SetBackgroundColour(wxColour(200, 100, 50));
     kbPanel->SetMinSize(wxSize(-1, 200));
@@ -147,46 +181,85 @@ void BibirbleWindow::SetupKeyboard(wxBoxSizer* parentLayout) {
 }
 
 
+void BibirbleWindow::SetupUserData() {
+    TRACE_SCOPE("BibirbleWindow::SetupUserData");
+    wxFileName state(wxStandardPaths::Get().GetUserDataDir(), "rotation.state");
+    if (state.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+        m_rotationPath = std::string(state.GetFullPath().utf8_str());
+        if (!m_history.open(std::string(state.GetPath().utf8_str()))) {
+            wxLogWarning("Game history in %s cannot be used; results will not be saved.", state.GetPath());
+        }
+    }
+    if (m_rotationPath.empty() || !m_rotation.load(m_rotationPath, m_data.verseCount())) {
+        m_rotation.reset(m_data.verseCount(), std::random_device{}());
+    }
+}
+
+
 void BibirbleWindow::StartNewGame() {
+    TRACE_SCOPE("BibirbleWindow::StartNewGame");
     if (!m_data.isLoaded()) {
         m_revealPanel->SetLabel("Failed to load data. Please ensure bible_sections.json is in the directory.");
         m_submitBtn->Enable(false);
+        m_hintBtn->Enable(false);
+        m_dailyBtn->Enable(false);
         return;
     }
     
-    m_targetVerse = m_data.getRandomVerse();
-    wxLogMessage("Target: %s %d:%d", m_targetVerse.book, m_targetVerse.chapter, m_targetVerse.verse);
+    if (m_dailyGame) {
+        m_engine.start(m_daily.verseFor(m_dailyDate));
+    } else if (m_engine.difficulty() == Difficulty::Normal) {
+        m_engine.start(m_rotation.next());
+        if (!m_rotationPath.empty()) m_rotation.save(m_rotationPath);
+    } else {
+        m_engine.start();
+    }
+    const Verse& target = m_engine.target();
+    wxLogMessage("Target: %s %d:%d", ToWx(target.book), target.chapter, target.verse);
+
+    for (int stage = 0; stage < GameEngine::kRevealStages; ++stage) {
+        m_revealStages[stage] = ToWx(m_engine.revealText(stage));
+    }
+    m_revealAnswer = wxString::Format("%s\n\n- %s %d:%d",
+                                      m_revealStages.back(),
+                                      ToWx(target.book), target.chapter, target.verse);
     
-    m_currentStage = 0;
-    m_gameOver = false;
     m_submitBtn->SetLabel("Submit Answer");
     m_submitBtn->Enable(true);
+    m_hintBtn->Enable(true);
     
     for (int i = 0; i < (int)m_rows.size(); ++i) {
-        m_rows[i]->setDisabled(true);
+        m_rows[i]->reset();
     }
     if (!m_rows.empty()) {
         m_rows[0]->setDisabled(false);
     }
     
     UpdateRevealText();
+    UpdateRemainingCount();
 }
 
 
 void BibirbleWindow::UpdateRevealText() {
-    wxString text;
-    if (m_gameOver && m_currentStage == -1) {
-        text = wxString::Format("%s\n\n- %s %d:%d",
-                               m_data.getRevealedText(m_targetVerse, 7),
-                               m_targetVerse.book, m_targetVerse.chapter, m_targetVerse.verse);
+    TRACE_SCOPE("BibirbleWindow::UpdateRevealText");
+    if (m_engine.isOver()) {
+        m_revealPanel->SetLabel(m_revealAnswer);
     } else {
-        text = m_data.getRevealedText(m_targetVerse, m_currentStage);
+        m_revealPanel->SetLabel(m_revealStages[m_engine.guessCount()]);
     }
-    m_revealPanel->SetLabel(text);
     m_revealPanel->Wrap(400);
 }
 
 
+void BibirbleWindow::UpdateRemainingCount() {
+    const std::size_t remaining = m_engine.remainingCount();
+    m_remainingLabel->SetLabel(remaining == 1
+        ? wxString("1 verse remains")
+        : wxString::Format("%lu verses remain", static_cast<unsigned long>(remaining)));
+    m_centralPanel->Layout();
+}
+
+
 void BibirbleWindow::HandleKeyPress(const wxString& key) {
     auto isEditableDigit = [](wxTextCtrl* ctrl) {
         return ctrl && ctrl->IsEnabled() && ctrl->IsEditable();
@@ -200,8 +273,9 @@ void BibirbleWindow::HandleKeyPress(const wxString& key) {
 
     // If nothing focused, pick the first editable digit in the current active row
     if (!focused) {
-        if (m_currentStage >= 0 && m_currentStage < (int)m_rows.size()) {
-            auto ctrls = m_rows[m_currentStage]->GetDigitCtrls();
+        const int activeRow = m_engine.guessCount();
+        if (!m_engine.isOver() && activeRow < (int)m_rows.size()) {
+            auto ctrls = m_rows[activeRow]->GetDigitCtrls();
             for (auto* c : ctrls) {
                 if (isEditableDigit(c)) { focused = c; break; }
             }
@@ -251,107 +325,149 @@ void BibirbleWindow::OnVirtualKeyClicked(wxCommandEvent& event) {
 }
 
 void BibirbleWindow::OnSubmit(wxCommandEvent& event) {
-    if (m_gameOver) return;
+    if (!m_engine.isStarted()) return;
+    if (m_engine.isOver()) {
+        OnShare(event);
+        return;
+    }
     
-    if (m_currentStage >= (int)m_rows.size()) return;
+    if (m_engine.guessCount() >= (int)m_rows.size()) return;
     
-    GameRow* activeRow = m_rows[m_currentStage];
+    GameRow* activeRow = m_rows[m_engine.guessCount()];
     if (!activeRow->isComplete()) {
         wxMessageBox("Please complete all fields in the current row before submitting.",
                     "Bibirble", wxOK | wxICON_WARNING);
         return;
     }
     
-    int result = ProcessTurn();
-    if (result == -1) {
-        m_gameOver = true;
-        m_currentStage = -1;
-        UpdateRevealText();
+    ProcessTurn();
+    UpdateRevealText();
+    UpdateRemainingCount();
+    if (m_engine.isOver()) {
         m_submitBtn->SetLabel("Share");
-        Unbind(wxEVT_BUTTON, &BibirbleWindow::OnSubmit, this, wxID_OK);
-        Bind(wxEVT_BUTTON, &BibirbleWindow::OnShare, this, wxID_OK);
-    } else {
-        m_currentStage = result;
-        UpdateRevealText();
+        m_hintBtn->Enable(false);
+        // A failed append is retried with the next game; warn once per session.
+        if (m_history.writeFailed() && !m_historyWarned) {
+            m_historyWarned = true;
+            wxLogWarning("Some results could not be saved to the game history.");
+        }
+        m_history.record(MakeGameRecord(m_engine, m_data.store(), m_dailyGame,
+                                        static_cast<int32_t>(DaysFromCivil(Today()))));
     }
 }
 
 
-int BibirbleWindow::ProcessTurn() {
-    GameRow* activeRow = m_rows[m_currentStage];
-    
-    std::string bookGuess = activeRow->getBook();
-    std::vector<std::string> inputs = activeRow->getDigits();
-    
-    int correctCount = 0;
-    
-    // Check Book
-    if (bookGuess == m_targetVerse.book) {
-        activeRow->setBookColor("green");
-        correctCount++;
-    } else if (m_data.getBookArea(bookGuess) == m_targetVerse.area) {
-        activeRow->setBookColor("yellow");
-    } else {
-        activeRow->setBookColor("gray");
-    }
-    
-    // Check Digits
-    char chStr[3], vStr[3];
-    snprintf(chStr, sizeof(chStr), "%02d", m_targetVerse.chapter);
-    snprintf(vStr, sizeof(vStr), "%02d", m_targetVerse.verse);
-    std::vector<std::string> answerDigits = {
-        std::string(1, chStr[0]), std::string(1, chStr[1]),
-        std::string(1, vStr[0]), std::string(1, vStr[1])
-    };
-    
-    std::vector<std::string> results(4, "gray");
-    std::vector<std::string> answerPool = answerDigits;
-    
-    // Pass 1: Green
-    for (int i = 0; i < 4; ++i) {
-        if (inputs[i] == answerPool[i]) {
-            results[i] = "green";
-            answerPool[i] = "";
-            correctCount++;
+void BibirbleWindow::OnHint(wxCommandEvent& event) {
+    TRACE_SCOPE("BibirbleWindow::OnHint");
+    if (!m_engine.isStarted() || m_engine.isOver()) return;
+    if (m_engine.guessCount() >= (int)m_rows.size()) return;
+
+    if (!m_solver) {
+        m_solver.reset(new Solver(m_data.store()));
+        if (!m_data.sourcePath().empty()) {
+            m_solver->loadFirstGuess(FirstGuessCachePath(m_data.sourcePath()));
         }
     }
-    
-    // Pass 2: Yellow
-    for (int i = 0; i < 4; ++i) {
-        if (results[i] != "green") {
-            bool found = false;
-            for (int j = 0; j < 4; ++j) {
-                if (inputs[i] == answerPool[j] && !answerPool[j].empty()) {
-                    results[i] = "yellow";
-                    answerPool[j] = "";
-                    found = true;
-                    break;
-                }
-            }
-        }
+
+    wxBusyCursor busy;
+    const Hint hint = m_engine.guessCount() == 0 ? m_solver->firstGuess()
+                                                 : m_solver->bestGuess(m_engine.candidates());
+    if (!hint.valid()) return;
+    m_rows[m_engine.guessCount()]->setGuess(m_data.store().bookNames()[hint.book], hint.digitString());
+}
+
+
+void BibirbleWindow::OnDifficulty(wxCommandEvent& event) {
+    const Difficulty tier = static_cast<Difficulty>(m_difficultyChoice->GetSelection());
+    if (tier == m_engine.difficulty() && !m_dailyGame) return;
+
+    // Switching tiers deals a new verse, so confirm before abandoning a game.
+    if (m_engine.guessCount() > 0 && !m_engine.isOver() &&
+        wxMessageBox("Start a new game at this difficulty?", "Bibirble", wxYES_NO | wxICON_QUESTION) != wxYES) {
+        m_difficultyChoice->SetSelection(static_cast<int>(m_engine.difficulty()));
+        return;
+    }
+    m_engine.setDifficulty(tier);
+    m_dailyGame = false;
+    StartNewGame();
+}
+
+
+void BibirbleWindow::OnDaily(wxCommandEvent& event) {
+    const CalendarDate today = Today();
+    if (m_dailyGame && !m_engine.isOver() && DaysFromCivil(m_dailyDate) == DaysFromCivil(today)) return;
+    if (m_engine.guessCount() > 0 && !m_engine.isOver() &&
+        wxMessageBox("Abandon this game for the daily verse?", "Bibirble", wxYES_NO | wxICON_QUESTION) != wxYES) {
+        return;
     }
+    m_dailyGame = true;
+    m_dailyDate = today;
+    StartNewGame();
+}
+
+
+void BibirbleWindow::OnStats(wxCommandEvent& event) {
+    const HistoryStats& stats = m_history.stats();
+    if (stats.games == 0) {
+        wxMessageBox("No finished games yet.", "Statistics", wxOK | wxICON_INFORMATION);
+        return;
+    }
+
+    wxString text = wxString::Format("Played: %llu\nWon: %.0f%%\nCurrent streak: %u\nBest streak: %u\n\n",
+                                     static_cast<unsigned long long>(stats.games),
+                                     100.0 * stats.wins / stats.games, stats.currentStreak, stats.bestStreak);
+    for (int k = 1; k <= GameEngine::kMaxGuesses; ++k) {
+        text += wxString::Format("%d: %llu\n", k, static_cast<unsigned long long>(stats.guessHistogram[k]));
+    }
+    text += wxString::Format("Lost: %llu\n", static_cast<unsigned long long>(stats.guessHistogram[0]));
+
+    // The books that most often get away, among those played a few times.
+    constexpr uint32_t kMinPlays = 3;
+    constexpr std::size_t kWeakestShown = 5;
+    std::vector<std::size_t> played;
+    for (std::size_t b = 0; b < stats.books.size() && b < kBookCount; ++b) {
+        if (stats.books[b].plays >= kMinPlays) played.push_back(b);
+    }
+    const auto accuracy = [&](std::size_t b) { return double(stats.books[b].wins) / stats.books[b].plays; };
+    std::stable_sort(played.begin(), played.end(),
+                     [&](std::size_t a, std::size_t b) { return accuracy(a) < accuracy(b); });
+    if (!played.empty()) text += "\nHardest books:\n";
+    for (std::size_t i = 0; i < played.size() && i < kWeakestShown; ++i) {
+        const BookAccuracy& book = stats.books[played[i]];
+        text += wxString::Format("%s: %u of %u\n", ToWx(kBooks[played[i]].display), book.wins, book.plays);
+    }
+    wxMessageBox(text, "Statistics", wxOK | wxICON_INFORMATION);
+}
+
+
+void BibirbleWindow::ProcessTurn() {
+    TRACE_SCOPE("BibirbleWindow::ProcessTurn");
+    GameRow* activeRow = m_rows[m_engine.guessCount()];
+    
+    // Each box holds one character; anything else cannot match a digit.
+    std::string digits;
+    for (const auto& digit : activeRow->getDigits()) {
+        digits.push_back(digit.size() == 1 ? digit[0] : ' ');
+    }
+    const GuessResult result = m_engine.submit(activeRow->getBook(), digits);
     
-    activeRow->setDigitColors(results);
+    activeRow->setBookColor(result.book);
+    activeRow->setDigitColors(result.digits);
     activeRow->lockSubmitted();
     
-    if (correctCount == 5) {
+    const Verse& target = m_engine.target();
+    if (m_engine.status() == GameStatus::Won) {
         wxMessageBox("You got it correct!", "Winner", wxOK | wxICON_INFORMATION);
-        return -1;
-    } else if (m_currentStage + 1 >= (int)m_rows.size()) {
+    } else if (m_engine.status() == GameStatus::Lost) {
         wxString msg = wxString::Format(
             "You ran out of guesses. The correct answer was %s %d:%d. "
             "Maybe you should read your Bible to reflect on what you got wrong!",
-            m_targetVerse.book, m_targetVerse.chapter, m_targetVerse.verse);
+            ToWx(target.book), target.chapter, target.verse);
         wxMessageBox(msg, "Game Over", wxOK | wxICON_INFORMATION);
-        return -1;
-    }
-
-    // Enable next only after this row is locked with visible colors.
-    if (m_currentStage + 1 < (int)m_rows.size()) {
-        m_rows[m_currentStage + 1]->setDisabled(false);
+    } else if (m_engine.guessCount() < (int)m_rows.size()) {
+        // Enable next only after this row is locked with visible colors.
+        m_rows[m_engine.guessCount()]->setDisabled(false);
     }
-    
-    return m_currentStage + 1;
 }
 
 
@@ -364,9 +480,11 @@ void BibirbleWindow::FocusPrev() {
 }
 
 void BibirbleWindow::OnShare(wxCommandEvent& event) {
+    const Verse& target = m_engine.target();
+    const wxString title = m_dailyGame ? "Bibirble daily " + ToWx(FormatDate(m_dailyDate)) : wxString("Bibirble");
     wxString shareText = wxString::Format(
-        "Could you beat this score in Bibirble?\n\n- %s %d:%d\n\n(Result grid copied to clipboard)",
-        m_targetVerse.book, m_targetVerse.chapter, m_targetVerse.verse);
+        "Could you beat this score in %s?\n\n- %s %d:%d\n\n(Result grid copied to clipboard)",
+        title, ToWx(target.book), target.chapter, target.verse);
     
     if (wxTheClipboard->Open()) {
         wxTheClipboard->SetData(new wxTextDataObject(shareText));
@@ -1,38 +1,73 @@
 #pragma once
 
 #include <wx/wx.h>
+#include <array>
+#include <memory>
 #include "BibleData.h"
+#include "DailyPuzzle.h"
+#include "GameEngine.h"
+#include "GameHistory.h"
 #include "GameRow.h"
+#include "Solver.h"
+#include "VerseRotation.h"
 
 class BibirbleWindow : public wxFrame {
 public:
-    explicit BibirbleWindow(wxWindow* parent, const std::string& dataPath = "");
+    BibirbleWindow(wxWindow* parent, BibleData data);
     
 private:
     void SetupUi();
     void SetupKeyboard(wxBoxSizer* mainLayout);
+    void SetupUserData();
     void StartNewGame();
     void UpdateRevealText();
+    void UpdateRemainingCount();
     void HandleKeyPress(const wxString& key);
     void FocusNext();
     void FocusPrev();
-    int ProcessTurn();
+    void ProcessTurn();
     
     void OnVirtualKeyClicked(wxCommandEvent& event);
     void OnSubmit(wxCommandEvent& event);
+    void OnHint(wxCommandEvent& event);
+    void OnDifficulty(wxCommandEvent& event);
+    void OnDaily(wxCommandEvent& event);
+    void OnStats(wxCommandEvent& event);
     void OnShare(wxCommandEvent& event);
     
     BibleData m_data;
-    Verse m_targetVerse;
-    int m_currentStage = 0;
-    bool m_gameOver = false;
+    GameEngine m_engine;
+    // Normal games are dealt from a rotation saved in the user data
+    // directory, so verses don't repeat until all have been played.
+    VerseRotation m_rotation;
+    std::string m_rotationPath;
+    DailyPuzzle m_daily;
+    // Whether the current game is the daily puzzle, and for which date.
+    bool m_dailyGame = false;
+    CalendarDate m_dailyDate;
+    // Finished games, kept next to the rotation state.
+    GameHistory m_history;
+    bool m_historyWarned = false;
+    // Shared by every GameRow's dropdown.
+    std::unique_ptr<BookChoices> m_bookChoices;
+    // Created on the first Hint click.
+    std::unique_ptr<Solver> m_solver;
+    // Reveal labels for the current verse, built once in StartNewGame:
+    // one per stage, then the last stage followed by the reference.
+    std::array<wxString, GameEngine::kRevealStages> m_revealStages;
+    wxString m_revealAnswer;
     
     wxPanel* m_centralPanel;
     wxStaticText* m_revealPanel;
+    wxStaticText* m_remainingLabel;
+    wxChoice* m_difficultyChoice;
+    wxButton* m_dailyBtn;
+    wxButton* m_statsBtn;
     wxPanel* m_rowsPanel;
     wxBoxSizer* m_rowsSizer;
     wxVector<GameRow*> m_rows;
     wxButton* m_submitBtn;
+    wxButton* m_hintBtn;
     
     wxWindow* m_focusedInput;
     
@@ -1,213 +1,612 @@
 #include "BibleData.h"
+#include "Trace.h"
+#include "VerseScanner.h"
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
-#include <cmath>
+#include <iterator>
 #include <algorithm>
 #include <random>
-#include <sstream>
-#include <set>
 #include <string>
-#include <map>
+#include <system_error>
 #include <vector>
+#include <utility>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#elif defined(__APPLE__)
+#  include <mach-o/dyld.h>
+#endif
+
+namespace fs = std::filesystem;
 
 BibleData::BibleData() {}
 
-std::string BibleData::ResolveDataFilePath(const std::string& preferredPath) {
-    std::vector<std::string> candidates;
-    if (!preferredPath.empty()) {
-        candidates.push_back(preferredPath);
-    }
-
-    const std::vector<std::string> defaults = {
-        "bible_sections.json",
-        "./bible_sections.json",
-        "../bible_sections.json",
-        "Release/bible_sections.json",
-        "./Release/bible_sections.json",
-        "../Release/bible_sections.json",
-        "Debug/bible_sections.json",
-        "./Debug/bible_sections.json",
-        "../Debug/bible_sections.json",
-        "build/bible_sections.json",
-        "./build/bible_sections.json",
-        "../build/bible_sections.json",
-        "build/Release/bible_sections.json",
-        "./build/Release/bible_sections.json",
-        "../build/Release/bible_sections.json",
-        "build/Debug/bible_sections.json",
-        "./build/Debug/bible_sections.json",
-        "../build/Debug/bible_sections.json"
+namespace {
+
+constexpr const char* kDataFileName = "bible_sections.json";
+
+// Set by BibleData::UseEmbeddedCorpus.
+struct EmbeddedImage {
+    const void* data = nullptr;
+    std::size_t size = 0;
+};
+EmbeddedImage g_embedded;
+
+// One stat, no open: the loaders report unreadable files themselves.
+bool fileExists(const fs::path& path) {
+    std::error_code ec;
+    return fs::is_regular_file(path, ec);
+}
+
+fs::path executableDirectory() {
+#if defined(_WIN32)
+    wchar_t buffer[MAX_PATH];
+    const DWORD length = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
+    if (length == 0 || length == MAX_PATH) return fs::path();
+    return fs::path(std::wstring(buffer, length)).parent_path();
+#elif defined(__APPLE__)
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::string buffer(size, '\0');
+    if (_NSGetExecutablePath(&buffer[0], &size) != 0) return fs::path();
+    return fs::path(buffer.c_str()).parent_path();
+#else
+    std::error_code ec;
+    const fs::path exe = fs::read_symlink("/proc/self/exe", ec);
+    return ec ? fs::path() : exe.parent_path();
+#endif
+}
+
+// The corpus named by `path`: the path itself when it or its binary twin
+// exists, or bible_sections.json inside it when it is a directory holding
+// either. Empty if there is nothing there.
+std::string corpusAt(const fs::path& path) {
+    std::error_code ec;
+    const fs::path json = fs::is_directory(path, ec) ? path / kDataFileName : path;
+    if (fileExists(json) || fileExists(BinaryCorpusPath(json.string()))) {
+        return json.string();
+    }
+    return "";
+}
+
+// A path the user named is kept even if nothing is there, so a typo fails
+// the load rather than quietly picking up some other corpus.
+std::string namedCorpus(const std::string& path) {
+    const std::string found = corpusAt(path);
+    return found.empty() ? path : found;
+}
+
+// BIBIRBLE_DATA, then beside the executable and one level up (multi-config
+// generators put the executable in Release/ or Debug/ below the corpus),
+// then the working directory and its build/. An embedded corpus replaces
+// the directory search.
+std::string searchCorpus() {
+    const char* env = std::getenv("BIBIRBLE_DATA");
+    if (env && *env) {
+        return namedCorpus(env);
+    }
+    if (g_embedded.data) {
+        return "";
+    }
+    const fs::path exeDir = executableDirectory();
+    std::vector<fs::path> dirs;
+    if (!exeDir.empty()) {
+        dirs.push_back(exeDir);
+        dirs.push_back(exeDir.parent_path());
+    }
+    dirs.push_back(fs::path("."));
+    dirs.push_back(fs::path("build"));
+    for (const fs::path& dir : dirs) {
+        std::string found = corpusAt(dir / kDataFileName);
+        if (!found.empty()) {
+            return found;
+        }
+    }
+    return "";
+}
+
+class ProgressReporter {
+public:
+    explicit ProgressReporter(const LoadProgress& callback) : m_callback(callback) {}
+
+    void report(int percent) {
+        if (m_callback && percent != m_last) {
+            m_last = percent;
+            m_callback(percent);
+        }
+    }
+
+    // Maps `done` out of `total` onto the [from, to] slice of the gauge.
+    void report(std::size_t done, std::size_t total, int from, int to) {
+        if (total == 0) return;
+        report(from + static_cast<int>((to - from) * std::min(done, total) / total));
+    }
+
+private:
+    const LoadProgress& m_callback;
+    int m_last = -1;
+};
+
+// Single-pass character iterator over a streambuf that counts consumed bytes,
+// so the JSON parser itself drives the progress gauge.
+class CountingInputIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = char;
+
+    struct State {
+        std::size_t consumed = 0;
+        std::size_t total = 0;
+        int from = 0;
+        int to = 100;
+        ProgressReporter* reporter = nullptr;
     };
 
-    candidates.insert(candidates.end(), defaults.begin(), defaults.end());
+    CountingInputIterator() = default;
+    CountingInputIterator(std::streambuf* buffer, State* state) : m_buffer(buffer), m_state(state) {}
 
-    for (const auto& candidate : candidates) {
-        std::ifstream file(candidate, std::ios::binary);
-        if (file.good()) {
-            return candidate;
+    char operator*() const { return std::char_traits<char>::to_char_type(m_buffer->sgetc()); }
+
+    CountingInputIterator& operator++() {
+        m_buffer->sbumpc();
+        if ((++m_state->consumed & 0xFFFF) == 0 && m_state->reporter) {
+            m_state->reporter->report(m_state->consumed, m_state->total, m_state->from, m_state->to);
         }
+        return *this;
     }
 
-    return "";
+    bool operator==(const CountingInputIterator& other) const { return atEnd() == other.atEnd(); }
+    bool operator!=(const CountingInputIterator& other) const { return !(*this == other); }
+
+private:
+    bool atEnd() const {
+        return !m_buffer || std::char_traits<char>::eq_int_type(m_buffer->sgetc(), std::char_traits<char>::eof());
+    }
+
+    std::streambuf* m_buffer = nullptr;
+    State* m_state = nullptr;
+};
+
+std::size_t streamSize(std::istream& file) {
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    return static_cast<std::size_t>(std::max<std::streamoff>(0, size));
+}
+
+// SAX handler that turns the top-level array of verse objects into VerseStore
+// rows as each object closes, so no DOM is ever built. Field handling mirrors
+// json::value(): missing keys take their default, mistyped known keys fail the
+// load, and unknown keys (including nested values) are skipped.
+class VerseSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit VerseSaxHandler(VerseStore& store) : m_store(store) {}
+
+    bool null() override { return scalar(); }
+    bool boolean(bool) override { return scalar(); }
+    bool number_integer(number_integer_t val) override { return number(val); }
+    bool number_unsigned(number_unsigned_t val) override { return number(SaturateToInt64(val)); }
+    bool number_float(number_float_t val, const string_t&) override { return number(SaturateToInt64(val)); }
+    bool binary(binary_t&) override { return scalar(); }
+
+    bool string(string_t& val) override {
+        if (m_depth != kFieldDepth) return m_depth > kFieldDepth;
+        if (std::string* field = stringField()) {
+            field->swap(val);
+            return true;
+        }
+        return !isNumberField();
+    }
+
+    bool start_object(std::size_t) override {
+        if (m_depth == kVerseDepth) {
+            m_testament.clear();
+            m_area.clear();
+            m_book.clear();
+            m_text.clear();
+            m_chapter = 0;
+            m_verse = 0;
+        } else if (!skippable()) {
+            return false;
+        }
+        ++m_depth;
+        return true;
+    }
+
+    bool end_object() override {
+        if (--m_depth == kVerseDepth) {
+            return m_store.append(m_testament, m_area, m_book, m_chapter, m_verse, m_text);
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (m_depth != 0 && !skippable()) return false;
+        ++m_depth;
+        return true;
+    }
+
+    bool end_array() override {
+        --m_depth;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (m_depth == kFieldDepth) m_key.swap(val);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        return false;
+    }
+
+private:
+    // Depth 1 is inside the top-level array, depth 2 inside one verse object.
+    static constexpr std::size_t kVerseDepth = 1;
+    static constexpr std::size_t kFieldDepth = 2;
+
+    bool isNumberField() const { return m_key == "chapter" || m_key == "verse"; }
+    bool isStringField() const {
+        return m_key == "testament" || m_key == "area" || m_key == "book" || m_key == "text";
+    }
+
+    // Containers are only tolerated as (or inside) the value of an unknown key.
+    bool skippable() const {
+        return m_depth > kFieldDepth || (m_depth == kFieldDepth && !isNumberField() && !isStringField());
+    }
+
+    std::string* stringField() {
+        if (m_key == "testament") return &m_testament;
+        if (m_key == "area") return &m_area;
+        if (m_key == "book") return &m_book;
+        if (m_key == "text") return &m_text;
+        return nullptr;
+    }
+
+    bool scalar() const {
+        if (m_depth != kFieldDepth) return m_depth > kFieldDepth;
+        return !isNumberField() && !isStringField();
+    }
+
+    bool number(int64_t val) {
+        if (m_depth != kFieldDepth) return m_depth > kFieldDepth;
+        if (m_key == "chapter") {
+            m_chapter = val;
+            return true;
+        }
+        if (m_key == "verse") {
+            m_verse = val;
+            return true;
+        }
+        return !isStringField();
+    }
+
+    VerseStore& m_store;
+    std::size_t m_depth = 0;
+    std::string m_key;
+    std::string m_testament;
+    std::string m_area;
+    std::string m_book;
+    std::string m_text;
+    int64_t m_chapter = 0;
+    int64_t m_verse = 0;
+};
+
+}
+
+std::string BibleData::ResolveDataFilePath(const std::string& preferredPath) {
+    TRACE_SCOPE("BibleData::ResolveDataFilePath");
+    if (!preferredPath.empty()) {
+        return namedCorpus(preferredPath);
+    }
+    static const std::string searched = searchCorpus();
+    return searched;
 }
 
-bool BibleData::loadData(const std::string& filePath) {
+bool BibleData::loadData(const std::string& filePath, const LoadProgress& progress) {
+    TRACE_SCOPE("BibleData::loadData");
     const std::string resolvedPath = ResolveDataFilePath(filePath);
     if (resolvedPath.empty()) {
+        if (!g_embedded.data || !attachCorpus(g_embedded.data, g_embedded.size)) {
+            return false;
+        }
+        m_corpusFile.close();
+        m_sourcePath.clear();
+        if (progress) progress(100);
+        return true;
+    }
+
+    // Prefer the prebuilt binary corpus next to the JSON; it is mapped, not parsed.
+    const std::string binaryPath = BinaryCorpusPath(resolvedPath);
+    if (fileExists(binaryPath) && loadBinary(binaryPath)) {
+        m_sourcePath = binaryPath;
+        if (progress) progress(100);
+        return true;
+    }
+
+    if (!loadJson(resolvedPath, m_jsonLoader, progress)) {
+        return false;
+    }
+    m_sourcePath = resolvedPath;
+    return true;
+}
+
+bool BibleData::loadBinary(const std::string& filePath) {
+    TRACE_SCOPE("BibleData::loadBinary");
+    MappedFile file;
+    if (!file.open(filePath) || !attachCorpus(file.data(), file.size())) {
         return false;
     }
+    m_corpusFile = std::move(file);
+    return true;
+}
+
+void BibleData::UseEmbeddedCorpus(const void* data, std::size_t size) {
+    g_embedded.data = data;
+    g_embedded.size = size;
+}
+
+bool BibleData::attachCorpus(const void* data, std::size_t size) {
+    TRACE_SCOPE("BibleData::attachCorpus");
+    CorpusView view;
+    if (!OpenCorpusView(data, size, view)) {
+        return false;
+    }
+
+    m_store.attach(view);
+    buildIndexes();
+    return true;
+}
+
+bool BibleData::loadJson(const std::string& filePath, JsonLoader loader, const LoadProgress& progress) {
+    if (loader == JsonLoader::Scanner) {
+        return loadJsonScanner(filePath, progress);
+    }
 
-    std::ifstream file(resolvedPath);
+    std::ifstream file(filePath, std::ios::binary);
     if (!file.is_open()) {
         return false;
     }
 
     try {
-        json arr;
-        file >> arr;
-        
-        if (!arr.is_array()) {
-            return false;
-        }
-        
-        m_verses.clear();
-        for (const auto& obj : arr) {
-            Verse v;
-            v.testament = obj.value("testament", "");
-            v.area = obj.value("area", "");
-            v.book = obj.value("book", "");
-            v.chapter = obj.value("chapter", 0);
-            v.verse = obj.value("verse", 0);
-            v.text = obj.value("text", "");
-            m_verses.push_back(v);
-        }
-        return true;
+        return loader == JsonLoader::Document
+            ? loadJsonDocument(file, progress)
+            : loadJsonStreaming(file, progress);
     } catch (...) {
         return false;
     }
 }
 
-Verse BibleData::getRandomVerse() const {
-    if (m_verses.empty()) return Verse();
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, m_verses.size() - 1);
-    return m_verses[dis(gen)];
-}
+bool BibleData::loadJsonScanner(const std::string& filePath, const LoadProgress& progress) {
+    TRACE_SCOPE("BibleData::loadJsonScanner");
+    MappedFile input;
+    if (!input.open(filePath)) {
+        return false;
+    }
 
-std::vector<std::string> BibleData::getAllBooks() const {
-    std::vector<std::string> books;
-    for (const auto& v : m_verses) {
-        if (std::find(books.begin(), books.end(), v.book) == books.end()) {
-            books.push_back(v.book);
-        }
+    ProgressReporter reporter(progress);
+    reporter.report(0);
+
+    const char* data = static_cast<const char*>(input.data());
+    VerseStore store;
+    store.reserve(input.size() / 256, input.size() / 2);
+    const bool ok = ScanVerseJson(data, input.size(), store, [&](std::size_t consumed) {
+        reporter.report(consumed, input.size(), 0, 100);
+    });
+    if (!ok) {
+        return false;
     }
-    return books;
-}
-
-std::string BibleData::getBookArea(const std::string& bookName) const {
-    static const std::map<std::string, std::vector<std::string>> AREAS = {
-        {"Torah", {"genesis", "exodus", "leviticus", "numbers", "deuteronomy"}},
-        {"Historical", {"joshua", "judges", "1samuel", "2samuel", "1kings", "2kings", "1chronicles", "2chronicles"}},
-        {"Poems", {"psalms", "proverbs", "ecclesiastes", "songofsolomon", "lamentations"}},
-        {"Small stories", {"job", "esther", "jonah", "ruth", "ezra"}},
-        {"Prophets Major", {"isaiah", "jeremiah", "ezekiel", "daniel"}},
-        {"Prophets Minor", {"hosea", "joel", "amos", "obadiah", "micah", "nahum", "habakkuk", "zephaniah", "haggai", "zechariah", "malachi", "nehemiah"}},
-        {"Gospel", {"matthew", "mark", "luke", "john"}},
-        {"Acts from Hebrews", {"acts", "hebrews"}},
-        {"Pauls letters", {"romans", "1corinthians", "2corinthians", "galatians", "ephesians", "philippians", "colossians", "1thessalonians", "2thessalonians", "1timothy", "2timothy", "titus", "philemon"}},
-        {"Peter letters", {"1peter", "2peter"}},
-        {"James and Jude", {"james", "jude"}},
-        {"John Letters and Visions", {"1john", "2john", "3john", "revelation"}}
-    };
 
-    std::string lowerBookName = bookName;
-    std::transform(lowerBookName.begin(), lowerBookName.end(), lowerBookName.begin(), ::tolower);
+    store.shrinkToFit();
+    m_store = std::move(store);
+    m_corpusFile.close();
+    buildIndexes();
+    reporter.report(100);
+    return true;
+}
 
-    for (const auto& area : AREAS) {
-        for (const auto& book : area.second) {
-            if (book == lowerBookName) {
-                return area.first;
-            }
-        }
+bool BibleData::loadJsonStreaming(std::istream& file, const LoadProgress& progress) {
+    TRACE_SCOPE("BibleData::loadJsonStreaming");
+    ProgressReporter reporter(progress);
+    reporter.report(0);
+
+    CountingInputIterator::State state;
+    state.total = streamSize(file);
+    state.reporter = &reporter;
+
+    // Rough per-verse sizes of bible_sections.json keep the columns from
+    // regrowing; shrinkToFit trims the estimate once the real size is known.
+    VerseStore store;
+    store.reserve(state.total / 256, state.total / 2);
+    VerseSaxHandler handler(store);
+    if (!json::sax_parse(CountingInputIterator(file.rdbuf(), &state), CountingInputIterator(), &handler)) {
+        return false;
     }
-    return "";
+
+    store.shrinkToFit();
+    m_store = std::move(store);
+    m_corpusFile.close();
+    buildIndexes();
+    reporter.report(100);
+    return true;
 }
 
-int BibleData::calculateSliceSteps(int listLength, int chunkSize) {
-    int size = std::max(1, chunkSize);
-    return  std::ceil(listLength / size);
-}
-
-std::vector<std::vector<std::string>> BibleData::sliceList(const std::vector<std::string>& list, int chunkSize) {
-    int len = list.size();
-    int size = std::max(1, chunkSize);
-    int steps = calculateSliceSteps(len, size);
-    std::vector<std::vector<std::string>> chunks;
-    
-    int start = 0;
-    for (int i = 0; i < steps; i++) {
-        int end = std::min(start + size, len);
-        std::vector<std::string> chunk(list.begin() + start, list.begin() + end);
-        chunks.push_back(chunk);
-        start = end;
-    }
-    return chunks;
-}
-
-std::string BibleData::getRevealedText(const Verse& verse, int stage) {
-    if (stage == -1) return verse.text;
-
-    // Split text into words
-    std::vector<std::string> words;
-    std::istringstream iss(verse.text);
-    std::string word;
-    while (iss >> word) {
-        words.push_back(word);
-    }
-
-    if (words.empty()) return "";
-
-    // Logic from revealVerse in data.js
-    int slices = std::floor(words.size() / 7);
-    std::vector<std::vector<std::string>> chunks = sliceList(words, slices);
-    
-    std::set<int> visibleIndices;
-    
-    // Always show start chunk
-    if (!chunks.empty()) {
-        for (const auto& w : chunks[0]) {
-            auto it = std::find(words.begin(), words.end(), w);
-            if (it != words.end()) {
-                visibleIndices.insert(std::distance(words.begin(), it));
-            }
-        }
+bool BibleData::loadJsonDocument(std::istream& file, const LoadProgress& progress) {
+    TRACE_SCOPE("BibleData::loadJsonDocument");
+    ProgressReporter reporter(progress);
+    reporter.report(0);
+
+    // Parsing dominates the load, so it gets most of the gauge; converting
+    // the DOM into the store fills the rest.
+    CountingInputIterator::State state;
+    state.total = streamSize(file);
+    state.to = 80;
+    state.reporter = &reporter;
+
+    json arr;
+    {
+        TRACE_SCOPE("json::parse");
+        arr = json::parse(CountingInputIterator(file.rdbuf(), &state), CountingInputIterator());
+    }
+    if (!arr.is_array()) {
+        return false;
     }
 
-    // Show chunks up to stage
-    for (int i = 1; i <= stage; i++) {
-        if (i >= (int)chunks.size()) break;
-        for (const auto& w : chunks[i]) {
-            auto it = std::find(words.begin(), words.end(), w);
-            if (it != words.end()) {
-                visibleIndices.insert(std::distance(words.begin(), it));
+    VerseStore store;
+    {
+        TRACE_SCOPE("convert verses");
+        store.reserve(arr.size(), 0);
+        std::size_t converted = 0;
+        for (const auto& obj : arr) {
+            const bool ok = store.append(obj.value("testament", ""), obj.value("area", ""),
+                                         obj.value("book", ""), obj.value("chapter", int64_t{0}),
+                                         obj.value("verse", int64_t{0}), obj.value("text", ""));
+            if (!ok) {
+                return false;
             }
+            reporter.report(++converted, arr.size(), 80, 100);
         }
     }
+    store.shrinkToFit();
+    m_store = std::move(store);
+    m_corpusFile.close();
+    buildIndexes();
+    reporter.report(100);
+    return true;
+}
 
-    // Build masked verse
-    std::vector<std::string> maskedVerse;
-    for (size_t i = 0; i < words.size(); ++i) {
-        if (visibleIndices.count(i)) {
-            maskedVerse.push_back(words[i]);
-        } else {
-            maskedVerse.push_back("...");
+Verse BibleData::verseAt(std::size_t index) const {
+    Verse v;
+    v.id = index;
+    v.testament = m_store.testamentNames()[m_store.testamentId(index)];
+    v.area = m_store.areaNames()[m_store.areaId(index)];
+    v.book = m_store.bookNames()[m_store.bookId(index)];
+    v.chapter = m_store.chapter(index);
+    v.verse = m_store.verse(index);
+    v.text = m_store.text(index);
+    return v;
+}
+
+Verse BibleData::getRandomVerse(Difficulty tier) const {
+    if (!isLoaded()) return Verse();
+    thread_local std::mt19937_64 gen(std::random_device{}());
+    return verseAt(sampleVerse(tier, gen));
+}
+
+std::size_t BibleData::sampleVerse(Difficulty tier, std::mt19937_64& rng) const {
+    const AliasTable& table = m_tiers[static_cast<int>(tier)];
+    if (tier == Difficulty::Normal || table.empty()) {
+        // Plain modulo so a seeded generator picks the same verses with every
+        // standard library; the bias is negligible at 64 bits.
+        return static_cast<std::size_t>(rng() % verseCount());
+    }
+    return table.sample(rng);
+}
+
+void BibleData::buildIndexes() {
+    TRACE_SCOPE("BibleData::buildIndexes");
+    if (!m_store.hasDifficulty()) {
+        TRACE_SCOPE("ComputeDifficultyScores");
+        m_store.setDifficulty(ComputeDifficultyScores(m_store));
+    }
+    std::vector<double> weights(m_store.size());
+    for (const Difficulty tier : {Difficulty::Easy, Difficulty::Normal, Difficulty::Hard}) {
+        AliasTable& table = m_tiers[static_cast<int>(tier)];
+        table.clear();
+        if (tier == Difficulty::Normal || !m_store.hasDifficulty()) continue;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            weights[i] = DifficultyWeight(tier, m_store.difficulty(i));
         }
+        TRACE_SCOPE("AliasTable::build");
+        table.build(weights);
     }
+    {
+        TRACE_SCOPE("ReferenceIndex::build");
+        m_references.build(m_store);
+    }
+
+    // Canonical ids sort first; kNoBook (0xFF) puts unknown books last.
+    std::vector<uint8_t> order(m_store.bookNames().size());
+    for (std::size_t b = 0; b < order.size(); ++b) order[b] = static_cast<uint8_t>(b);
+    std::stable_sort(order.begin(), order.end(), [this](uint8_t a, uint8_t b) {
+        return m_store.canonicalBook(a) < m_store.canonicalBook(b);
+    });
+    m_bookOrder.clear();
+    for (const uint8_t b : order) m_bookOrder.push_back(m_store.bookNames()[b]);
+}
+
+std::size_t BibleData::findVerse(std::string_view book, int chapter, int verse) const {
+    const uint8_t id = m_store.findBook(book);
+    if (id == kNoLabel || chapter < 0 || verse < 0) return ReferenceIndex::kNoVerse;
+    return m_references.find(id, static_cast<unsigned>(chapter), static_cast<unsigned>(verse));
+}
 
+namespace {
+
+// Canonical id of a book name in any letter case, or kNoBook.
+uint8_t canonicalBook(std::string bookName) {
+    std::transform(bookName.begin(), bookName.end(), bookName.begin(), ::tolower);
+    return FindBookId(bookName);
+}
+
+}
+
+std::string BibleData::getBookArea(const std::string& bookName) {
+    const uint8_t id = canonicalBook(bookName);
+    return id != kNoBook ? std::string(kAreaNames[kBooks[id].area]) : std::string();
+}
+
+std::string BibleData::getBookTestament(const std::string& bookName) {
+    // Names outside the table have always counted as New Testament.
+    const uint8_t id = canonicalBook(bookName);
+    return id != kNoBook ? std::string(kTestamentNames[kBooks[id].testament]) : "New Testament";
+}
+
+int BibleData::getBookFamiliarity(const std::string& bookName) {
+    const uint8_t id = canonicalBook(bookName);
+    return id != kNoBook ? kBooks[id].familiarity : 0;
+}
+
+std::string BibleData::getRevealedText(const Verse& verse, int stage) const {
     std::string result;
-    for (size_t i = 0; i < maskedVerse.size(); ++i) {
-        if (i > 0) result += " ";
-        result += maskedVerse[i];
-    }
+    getRevealedText(verse, stage, result);
     return result;
 }
+
+void BibleData::getRevealedText(const Verse& verse, int stage, std::string& out) const {
+    TRACE_SCOPE("BibleData::getRevealedText");
+    out.clear();
+    if (stage == -1) {
+        out.assign(verse.text.data(), verse.text.size());
+        return;
+    }
+
+    const std::size_t wordCount = m_store.wordCount(verse.id);
+    if (wordCount == 0) return;
+    const CorpusWordSpan* spans = m_store.wordSpans(verse.id);
+
+    // Logic from revealVerse in data.js: the words are cut into chunks of
+    // words/7 (at least one), the first chunk is always shown and each stage
+    // adds one more. Words past the last whole chunk are never revealed.
+    const std::size_t chunkSize = std::max<std::size_t>(1, wordCount / 7);
+    const std::size_t chunkCount = wordCount / chunkSize;
+    const std::size_t shownChunks = std::min<std::size_t>(std::max(stage, 0) + 1, chunkCount);
+    const std::size_t visibleWords = shownChunks * chunkSize;
+
+    out.reserve(verse.text.size() + 3 * wordCount);
+    for (std::size_t i = 0; i < wordCount; ++i) {
+        if (i > 0) out.push_back(' ');
+        if (i < visibleWords) {
+            out.append(verse.text.data() + spans[i].begin, spans[i].end - spans[i].begin);
+        } else {
+            out.append("...", 3);
+        }
+    }
+}
@@ -1,34 +1,114 @@
 #pragma once
 
+#include <array>
+#include <functional>
+#include <random>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
 #include <nlohmann/json.hpp>
+#include "AliasTable.h"
+#include "CorpusFormat.h"
+#include "Difficulty.h"
+#include "MappedFile.h"
+#include "ReferenceIndex.h"
+#include "VerseStore.h"
 
 using json = nlohmann::json;
 
+// Lightweight view of one verse in a BibleData store. The string views point
+// into the store and stay valid for as long as the owning BibleData does.
 struct Verse {
-    std::string testament;
-    std::string area;
-    std::string book;
-    int chapter;
-    int verse;
-    std::string text;
+    std::size_t id = 0;
+    std::string_view testament;
+    std::string_view area;
+    std::string_view book;
+    int chapter = 0;
+    int verse = 0;
+    std::string_view text;
 };
 
+// How bible_sections.json is parsed when no binary corpus is available.
+enum class JsonLoader {
+    Scanner,    // schema-specific SIMD scanner over the mapped file (VerseScanner.h)
+    Streaming,  // nlohmann SAX events appended straight into the store
+    Document    // full nlohmann DOM, converted once parsing finishes
+};
+
+// Receives overall load progress as a percentage in [0, 100]. Called from
+// whichever thread runs the load, only when the percentage changes.
+using LoadProgress = std::function<void(int percent)>;
+
 class BibleData {
 public:
     BibleData();
-    bool loadData(const std::string& filePath);
+    BibleData(BibleData&&) = default;
+    BibleData& operator=(BibleData&&) = default;
+
+    bool loadData(const std::string& filePath, const LoadProgress& progress = LoadProgress());
+    bool loadBinary(const std::string& filePath);
+    bool loadJson(const std::string& filePath, JsonLoader loader, const LoadProgress& progress = LoadProgress());
+    void setJsonLoader(JsonLoader loader) { m_jsonLoader = loader; }
+    // The corpus to load, named by its JSON path (the binary sits beside it
+    // and may be the only file present). A non-empty `preferredPath` (a file,
+    // or a directory holding bible_sections.json) is used as given; otherwise
+    // BIBIRBLE_DATA, then the executable's directory and its parent, then the
+    // working directory and build/ are checked. That search runs once per
+    // process and is cached. Empty if nothing was found, or if an embedded
+    // corpus stands in for the search.
     static std::string ResolveDataFilePath(const std::string& preferredPath = "");
-    Verse getRandomVerse() const;
-    std::vector<std::string> getAllBooks() const;
-    std::string getRevealedText(const Verse& verse, int stage);
-    std::string getBookArea(const std::string& bookName) const;
-    bool isLoaded() const { return !m_verses.empty(); }
+    // Serves the corpus from a bible_sections.bin image in memory (see
+    // EmbeddedCorpus.h) unless --data or BIBIRBLE_DATA names a file. The
+    // directory search is then skipped; validation and buildIndexes run as
+    // for a mapped file. Call before the first load; the
+    // image must outlive every BibleData.
+    static void UseEmbeddedCorpus(const void* data, std::size_t size);
+    Verse getRandomVerse(Difficulty tier = Difficulty::Normal) const;
+    // Index of a verse drawn for `tier` in constant time: uniformly for
+    // Normal, through the tier's alias table (built at load) otherwise.
+    std::size_t sampleVerse(Difficulty tier, std::mt19937_64& rng) const;
+    // Distinct book names in canonical order (BookTable.h), then any books
+    // the table does not know in store order; built once at load.
+    const std::vector<std::string>& getAllBooks() const { return m_bookOrder; }
+    std::string getRevealedText(const Verse& verse, int stage) const;
+    // Writes the masked verse into `out`, reusing its capacity.
+    void getRevealedText(const Verse& verse, int stage, std::string& out) const;
+    static std::string getBookArea(const std::string& bookName);
+    static std::string getBookTestament(const std::string& bookName);
+    // 2 for widely known books, 1 for familiar ones, 0 for the rest.
+    static int getBookFamiliarity(const std::string& bookName);
+    bool isLoaded() const { return !m_store.empty(); }
+    std::size_t verseCount() const { return m_store.size(); }
+    Verse verseAt(std::size_t index) const;
+    const VerseStore& store() const { return m_store; }
+    // Lookups by reference; built at load alongside the store.
+    const ReferenceIndex& references() const { return m_references; }
+    // Store index of book chapter:verse, or ReferenceIndex::kNoVerse.
+    std::size_t findVerse(std::string_view book, int chapter, int verse) const;
+    // File the corpus came from in the last successful loadData; empty for
+    // the embedded corpus.
+    const std::string& sourcePath() const { return m_sourcePath; }
 
 private:
-    std::vector<Verse> m_verses;
-    int calculateSliceSteps(int listLength, int chunkSize);
-    std::vector<std::vector<std::string>> sliceList(const std::vector<std::string>& list, int chunkSize);
+    // Attaches m_store to a corpus image and builds the indexes; the image
+    // must stay mapped while the store uses it.
+    bool attachCorpus(const void* data, std::size_t size);
+    bool loadJsonScanner(const std::string& filePath, const LoadProgress& progress);
+    bool loadJsonStreaming(std::istream& file, const LoadProgress& progress);
+    bool loadJsonDocument(std::istream& file, const LoadProgress& progress);
+    // Fills in difficulty scores if the source had none, then builds
+    // m_tiers, m_references and m_bookOrder. Runs on every load, mapped
+    // corpora included: linear for the alias tables, n log n for the
+    // reference sort.
+    void buildIndexes();
+
+    JsonLoader m_jsonLoader = JsonLoader::Scanner;
+    std::string m_sourcePath;
+    // Backing memory for m_store when it is attached to bible_sections.bin
+    // on disk; the embedded image needs none.
+    MappedFile m_corpusFile;
+    VerseStore m_store;
+    std::array<AliasTable, kDifficultyCount> m_tiers;
+    ReferenceIndex m_references;
+    std::vector<std::string> m_bookOrder;
 };
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// The canonical book table, generated from tools/books.tsv at build time.
+// A book's canonical id is its row: 0 is genesis, 65 revelation. The corpus
+// builder, the runtime and tools/sort.py all read the same rows.
+struct BookInfo {
+    std::string_view name;      // lower-case key used by the corpus, e.g. "1samuel"
+    std::string_view display;   // e.g. "1 Samuel"
+    uint8_t testament;          // index into kTestamentNames
+    uint8_t area;               // index into kAreaNames
+    uint8_t familiarity;        // 2 widely known, 1 familiar, 0 other
+    uint8_t chapters;
+};
+
+#include "BookTableData.h"
+
+constexpr std::size_t kBookCount = sizeof(kBooks) / sizeof(kBooks[0]);
+constexpr std::size_t kAreaCount = sizeof(kAreaNames) / sizeof(kAreaNames[0]);
+constexpr std::size_t kTestamentCount = sizeof(kTestamentNames) / sizeof(kTestamentNames[0]);
+constexpr uint8_t kNoBook = 0xFF;
+
+static_assert(kBookCount < kNoBook, "canonical book ids are uint8");
+
+namespace book_table_detail {
+
+// Open-addressed table with no collisions: name -> slot is FNV-1a under a
+// seed that the compiler searches for, so a lookup is one hash, one load and
+// one string compare. 512 slots for 66 names leaves a random seed about a 1%
+// chance of being collision-free, so the search ends after a few hundred tries.
+constexpr std::size_t kSlotCount = 512;
+
+constexpr uint32_t Hash(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (const char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    // Fold the high bits in; FNV's low bits mix poorly on short keys.
+    return (hash ^ (hash >> 15)) & (kSlotCount - 1);
+}
+
+constexpr bool IsPerfect(uint32_t seed) {
+    bool used[kSlotCount] = {};
+    for (const BookInfo& book : kBooks) {
+        const uint32_t slot = Hash(book.name, seed);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t FindSeed() {
+    uint32_t seed = 0;
+    while (!IsPerfect(seed)) ++seed;
+    return seed;
+}
+
+constexpr uint32_t kSeed = FindSeed();
+
+constexpr std::array<uint8_t, kSlotCount> BuildSlots() {
+    std::array<uint8_t, kSlotCount> slots = {};
+    for (auto& slot : slots) slot = kNoBook;
+    for (std::size_t id = 0; id < kBookCount; ++id) slots[Hash(kBooks[id].name, kSeed)] = static_cast<uint8_t>(id);
+    return slots;
+}
+
+constexpr std::array<uint8_t, kSlotCount> kSlots = BuildSlots();
+
+}
+
+// Canonical id of the book with corpus key `name` (exact, lower case), or kNoBook.
+constexpr uint8_t FindBookId(std::string_view name) {
+    const uint8_t id = book_table_detail::kSlots[book_table_detail::Hash(name, book_table_detail::kSeed)];
+    return id != kNoBook && kBooks[id].name == name ? id : kNoBook;
+}
+
+static_assert(FindBookId("genesis") == 0, "books.tsv must start at genesis");
+static_assert(FindBookId("revelation") == kBookCount - 1, "books.tsv must end at revelation");
+static_assert(FindBookId("Genesis") == kNoBook, "keys are lower case");
@@ -0,0 +1,173 @@
+#include "CandidateIndex.h"
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace {
+
+inline unsigned popCount(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned>(__popcnt64(bits));
+#elif defined(_MSC_VER)
+    return __popcnt(static_cast<uint32_t>(bits)) + __popcnt(static_cast<uint32_t>(bits >> 32));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(bits));
+#endif
+}
+
+}
+
+unsigned VerseBitset::CountTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<uint32_t>(bits))) return static_cast<unsigned>(index);
+    _BitScanForward(&index, static_cast<uint32_t>(bits >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+void VerseBitset::assign(std::size_t size, bool value) {
+    m_size = size;
+    m_words.assign((size + 63) / 64, value ? ~uint64_t(0) : 0);
+    if (value && size % 64 != 0) {
+        m_words.back() = (uint64_t(1) << (size % 64)) - 1;
+    }
+}
+
+std::size_t VerseBitset::count() const {
+    std::size_t total = 0;
+    for (const uint64_t word : m_words) total += popCount(word);
+    return total;
+}
+
+bool VerseBitset::none() const {
+    for (const uint64_t word : m_words) {
+        if (word) return false;
+    }
+    return true;
+}
+
+VerseBitset& VerseBitset::operator&=(const VerseBitset& other) {
+    for (std::size_t w = 0; w < m_words.size(); ++w) m_words[w] &= other.m_words[w];
+    return *this;
+}
+
+VerseBitset& VerseBitset::andNot(const VerseBitset& other) {
+    for (std::size_t w = 0; w < m_words.size(); ++w) m_words[w] &= ~other.m_words[w];
+    return *this;
+}
+
+void CandidateIndex::build(const VerseStore& store) {
+    m_size = store.size();
+    m_books.assign(store.bookNames().size(), VerseBitset(m_size));
+    m_areas.assign(store.areaNames().size(), VerseBitset(m_size));
+    for (auto& position : m_digits) {
+        for (auto& value : position) value.assign(m_size, false);
+    }
+
+    for (std::size_t i = 0; i < m_size; ++i) {
+        m_books[store.bookId(i)].set(i);
+        m_areas[store.areaId(i)].set(i);
+        const auto digits = AnswerDigits(store.chapter(i), store.verse(i));
+        for (int p = 0; p < 4; ++p) m_digits[p][digits[p]].set(i);
+    }
+}
+
+void CandidateIndex::narrow(VerseBitset& candidates, const ScoreCode& guess, PackedFeedback feedback) const {
+    const GuessResult result = GuessResult::Unpack(feedback);
+    const VerseBitset* book = guess.book < m_books.size() ? &m_books[guess.book] : nullptr;
+    const VerseBitset* area = guess.area < m_areas.size() ? &m_areas[guess.area] : nullptr;
+    auto impossible = [&candidates]() { candidates.assign(candidates.size(), false); };
+
+    switch (result.book) {
+    case Feedback::Green:
+        if (!book) return impossible();
+        candidates &= *book;
+        break;
+    case Feedback::Yellow:
+        if (!area) return impossible();
+        candidates &= *area;
+        if (book) candidates.andNot(*book);
+        break;
+    case Feedback::Gray:
+        if (book) candidates.andNot(*book);
+        if (area) candidates.andNot(*area);
+        break;
+    }
+
+    // Green positions pin the answer digit; every other position rules its
+    // guessed digit out there and leaves the answer digit in the yellow pool.
+    bool pooled[4];
+    for (int i = 0; i < 4; ++i) {
+        const uint8_t digit = guess.digits[i];
+        pooled[i] = result.digits[i] != Feedback::Green;
+        if (digit > 9) {
+            if (result.digits[i] != Feedback::Gray) return impossible();
+        } else if (pooled[i]) {
+            candidates.andNot(m_digits[i][digit]);
+        } else {
+            candidates &= m_digits[i][digit];
+        }
+    }
+
+    // Yellows for a digit value go to its pooled guess positions left to
+    // right, as long as the answer has unused copies. So `yellows` of
+    // `occurrences` pins the answer's pooled count of that value: exactly
+    // `yellows` if some occurrence stayed gray, at least `yellows` otherwise.
+    for (int i = 0; i < 4; ++i) {
+        const uint8_t value = guess.digits[i];
+        if (!pooled[i] || value > 9) continue;
+        bool seen = false;
+        for (int k = 0; k < i; ++k) seen = seen || (pooled[k] && guess.digits[k] == value);
+        if (seen) continue;
+
+        int occurrences = 0;
+        int yellows = 0;
+        bool grayed = false;
+        for (int k = i; k < 4; ++k) {
+            if (!pooled[k] || guess.digits[k] != value) continue;
+            ++occurrences;
+            if (result.digits[k] == Feedback::Yellow) {
+                if (grayed) return impossible();
+                ++yellows;
+            } else {
+                grayed = true;
+            }
+        }
+        const bool exact = yellows < occurrences;
+
+        // Count the pooled answer positions holding `value` per verse with a
+        // three-plane bit-sliced counter (0-4), then keep the matching counts.
+        uint64_t* out = candidates.words();
+        for (std::size_t w = 0; w < candidates.wordCount(); ++w) {
+            uint64_t s0 = 0, s1 = 0, s2 = 0;
+            for (int j = 0; j < 4; ++j) {
+                if (!pooled[j]) continue;
+                const uint64_t x = m_digits[j][value].words()[w];
+                const uint64_t carry = s0 & x;
+                s0 ^= x;
+                s2 |= s1 & carry;
+                s1 ^= carry;
+            }
+            uint64_t keep;
+            if (exact) {
+                keep = ((yellows & 1) ? s0 : ~s0) & ((yellows & 2) ? s1 : ~s1) & ((yellows & 4) ? s2 : ~s2);
+            } else {
+                switch (yellows) {
+                case 1: keep = s0 | s1 | s2; break;
+                case 2: keep = s1 | s2; break;
+                case 3: keep = (s0 & s1) | s2; break;
+                default: keep = s2; break;
+                }
+            }
+            out[w] &= keep;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Scoring.h"
+#include "VerseStore.h"
+
+// One bit per verse of a VerseStore, packed into 64-bit words. Bits past
+// size() are always zero so whole-word operations and count() stay exact.
+class VerseBitset {
+public:
+    VerseBitset() = default;
+    explicit VerseBitset(std::size_t size, bool value = false) { assign(size, value); }
+
+    void assign(std::size_t size, bool value);
+    std::size_t size() const { return m_size; }
+    void set(std::size_t index) { m_words[index >> 6] |= uint64_t(1) << (index & 63); }
+    bool test(std::size_t index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+    std::size_t count() const;
+    bool none() const;
+
+    VerseBitset& operator&=(const VerseBitset& other);
+    VerseBitset& andNot(const VerseBitset& other);
+
+    std::size_t wordCount() const { return m_words.size(); }
+    uint64_t* words() { return m_words.data(); }
+    const uint64_t* words() const { return m_words.data(); }
+
+    // Calls fn(index) for every set bit in ascending order.
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (std::size_t w = 0; w < m_words.size(); ++w) {
+            for (uint64_t bits = m_words[w]; bits; bits &= bits - 1) {
+                fn(w * 64 + CountTrailingZeros(bits));
+            }
+        }
+    }
+
+    static unsigned CountTrailingZeros(uint64_t bits);
+
+private:
+    std::vector<uint64_t> m_words;
+    std::size_t m_size = 0;
+};
+
+// Per-attribute bitsets over every verse of a store: one per book, one per
+// area and one per digit value at each of the four chapter:verse positions
+// (digits as in AnswerDigits). Narrowing a candidate set by one guess's
+// feedback is then a handful of word-wide AND/ANDNOT passes.
+class CandidateIndex {
+public:
+    void build(const VerseStore& store);
+    std::size_t size() const { return m_size; }
+
+    // Removes from `candidates` every verse `a` with Score(guess, a) != feedback.
+    void narrow(VerseBitset& candidates, const ScoreCode& guess, PackedFeedback feedback) const;
+
+private:
+    std::size_t m_size = 0;
+    std::vector<VerseBitset> m_books;
+    std::vector<VerseBitset> m_areas;
+    std::array<std::array<VerseBitset, 10>, 4> m_digits;
+};
@@ -0,0 +1,103 @@
+#include "CorpusFormat.h"
+#include <cstring>
+
+namespace {
+
+bool sectionFits(const CorpusSection& section, std::size_t fileSize, uint64_t expectedSize, std::size_t alignment) {
+    if (section.offset % alignment != 0) return false;
+    if (section.size != expectedSize) return false;
+    if (section.offset > fileSize) return false;
+    return section.size <= fileSize - section.offset;
+}
+
+template <typename T>
+const T* sectionData(const void* data, const CorpusSection& section) {
+    return reinterpret_cast<const T*>(static_cast<const char*>(data) + section.offset);
+}
+
+}
+
+std::string CorpusView::label(uint32_t index) const {
+    const CorpusLabel& l = labels[index];
+    return std::string(strings + l.offset, l.length);
+}
+
+std::string CorpusView::text(std::size_t index) const {
+    const uint32_t begin = textOffsets[index];
+    const uint32_t end = textOffsets[index + 1];
+    return std::string(strings + begin, end - begin);
+}
+
+bool OpenCorpusView(const void* data, std::size_t size, CorpusView& view) {
+    view = CorpusView();
+    if (!data || size < sizeof(CorpusHeader)) return false;
+
+    const CorpusHeader* header = static_cast<const CorpusHeader*>(data);
+    if (std::memcmp(header->magic, kCorpusMagic, sizeof(kCorpusMagic)) != 0) return false;
+    if (header->version != kCorpusVersion) return false;
+
+    const uint64_t n = header->verseCount;
+    const uint64_t labelCount = uint64_t(header->bookCount) + header->areaCount + header->testamentCount;
+    if (header->bookCount > kNoLabel || header->areaCount > kNoLabel || header->testamentCount > kNoLabel) return false;
+
+    const CorpusSection* s = header->sections;
+    if (!sectionFits(s[kCorpusLabels], size, labelCount * sizeof(CorpusLabel), 4)) return false;
+    if (!sectionFits(s[kCorpusBooks], size, n, 1)) return false;
+    if (!sectionFits(s[kCorpusAreas], size, n, 1)) return false;
+    if (!sectionFits(s[kCorpusTestaments], size, n, 1)) return false;
+    if (!sectionFits(s[kCorpusChapters], size, n * sizeof(uint16_t), 2)) return false;
+    if (!sectionFits(s[kCorpusVerses], size, n * sizeof(uint16_t), 2)) return false;
+    if (!sectionFits(s[kCorpusDifficulty], size, n * sizeof(uint16_t), 2)) return false;
+    if (!sectionFits(s[kCorpusTextOffsets], size, (n + 1) * sizeof(uint32_t), 4)) return false;
+    if (!sectionFits(s[kCorpusWordIndex], size, (n + 1) * sizeof(uint32_t), 4)) return false;
+    const uint64_t spanCount = sectionData<uint32_t>(data, s[kCorpusWordIndex])[n];
+    if (!sectionFits(s[kCorpusWordSpans], size, spanCount * sizeof(CorpusWordSpan), 4)) return false;
+    if (!sectionFits(s[kCorpusStrings], size, s[kCorpusStrings].size, 1)) return false;
+
+    view.header = header;
+    view.labels = sectionData<CorpusLabel>(data, s[kCorpusLabels]);
+    view.books = sectionData<uint8_t>(data, s[kCorpusBooks]);
+    view.areas = sectionData<uint8_t>(data, s[kCorpusAreas]);
+    view.testaments = sectionData<uint8_t>(data, s[kCorpusTestaments]);
+    view.chapters = sectionData<uint16_t>(data, s[kCorpusChapters]);
+    view.verses = sectionData<uint16_t>(data, s[kCorpusVerses]);
+    view.difficulty = sectionData<uint16_t>(data, s[kCorpusDifficulty]);
+    view.textOffsets = sectionData<uint32_t>(data, s[kCorpusTextOffsets]);
+    view.wordIndex = sectionData<uint32_t>(data, s[kCorpusWordIndex]);
+    view.wordSpans = sectionData<CorpusWordSpan>(data, s[kCorpusWordSpans]);
+    view.strings = sectionData<char>(data, s[kCorpusStrings]);
+    view.stringsSize = s[kCorpusStrings].size;
+
+    bool valid = view.textOffsets[n] <= view.stringsSize;
+    for (uint64_t i = 0; valid && i < labelCount; ++i) {
+        const CorpusLabel& l = view.labels[i];
+        valid = uint64_t(l.offset) + l.length <= view.stringsSize;
+    }
+    // One pass over the verse table, so that a corrupt or hand-edited file
+    // cannot send text(), the label lookups or the reveal masking outside
+    // the image. With the last offsets checked above, monotonic offsets keep
+    // every verse's text and spans in bounds.
+    for (uint64_t i = 0; valid && i < n; ++i) {
+        const uint32_t length = view.textOffsets[i + 1] - view.textOffsets[i];
+        valid = view.textOffsets[i] <= view.textOffsets[i + 1] && view.wordIndex[i] <= view.wordIndex[i + 1] &&
+                view.books[i] < header->bookCount && view.areas[i] < header->areaCount &&
+                view.testaments[i] < header->testamentCount;
+        for (uint32_t w = view.wordIndex[i]; valid && w < view.wordIndex[i + 1]; ++w) {
+            valid = view.wordSpans[w].begin <= view.wordSpans[w].end && view.wordSpans[w].end <= length;
+        }
+    }
+    if (!valid) {
+        view = CorpusView();
+        return false;
+    }
+    return true;
+}
+
+std::string BinaryCorpusPath(const std::string& jsonPath) {
+    const std::string ext = ".json";
+    if (jsonPath.size() >= ext.size() &&
+        jsonPath.compare(jsonPath.size() - ext.size(), ext.size(), ext) == 0) {
+        return jsonPath.substr(0, jsonPath.size() - ext.size()) + ".bin";
+    }
+    return jsonPath + ".bin";
+}
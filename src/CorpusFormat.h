@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Binary corpus layout written next to bible_sections.json (bible_sections.bin).
+// All integers are little-endian and every section offset is relative to the
+// start of the file. The file is designed to be mapped read-only and used in
+// place: opening it checks the header and makes one bounds-checking pass over
+// the per-verse sections (see OpenCorpusView), but copies nothing.
+//
+//   CorpusHeader
+//   labels      CorpusLabel[bookCount + areaCount + testamentCount]
+//   books       uint8_t[verseCount]   index into the book labels
+//   areas       uint8_t[verseCount]   index into the area labels
+//   testaments  uint8_t[verseCount]   index into the testament labels
+//   chapters    uint16_t[verseCount]
+//   verses      uint16_t[verseCount]
+//   difficulty  uint16_t[verseCount]  ComputeDifficultyScores (Difficulty.h)
+//   textOffsets uint32_t[verseCount + 1]  byte offsets into the string pool
+//   wordIndex   uint32_t[verseCount + 1]  first word span of each verse
+//   wordSpans   CorpusWordSpan[wordIndex[verseCount]]
+//   strings     UTF-8 string pool (verse text followed by label names)
+
+constexpr char kCorpusMagic[8] = {'B', 'I', 'B', 'L', 'C', 'O', 'R', 'P'};
+constexpr uint32_t kCorpusVersion = 3;
+
+// Label ids are uint8; 0xFF is reserved to mean "no such label", so each
+// table holds at most 255 names.
+constexpr uint8_t kNoLabel = 0xFF;
+
+enum CorpusSectionId : uint32_t {
+    kCorpusLabels,
+    kCorpusBooks,
+    kCorpusAreas,
+    kCorpusTestaments,
+    kCorpusChapters,
+    kCorpusVerses,
+    kCorpusDifficulty,
+    kCorpusTextOffsets,
+    kCorpusWordIndex,
+    kCorpusWordSpans,
+    kCorpusStrings,
+    kCorpusSectionCount
+};
+
+struct CorpusSection {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct CorpusHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t verseCount;
+    uint32_t bookCount;
+    uint32_t areaCount;
+    uint32_t testamentCount;
+    uint32_t reserved;
+    CorpusSection sections[kCorpusSectionCount];
+};
+
+struct CorpusLabel {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Byte range of one whitespace-delimited word, relative to the start of its
+// verse text. Verses are therefore limited to 64 KiB of text.
+struct CorpusWordSpan {
+    uint16_t begin;
+    uint16_t end;
+};
+
+static_assert(sizeof(CorpusHeader) == 32 + 16 * kCorpusSectionCount, "CorpusHeader must be tightly packed");
+static_assert(sizeof(CorpusLabel) == 8, "CorpusLabel must be tightly packed");
+static_assert(sizeof(CorpusWordSpan) == 4, "CorpusWordSpan must be tightly packed");
+
+// Typed pointers into a validated corpus image. The view does not own memory;
+// it stays valid as long as the underlying mapping does.
+struct CorpusView {
+    const CorpusHeader* header = nullptr;
+    const CorpusLabel* labels = nullptr;
+    const uint8_t* books = nullptr;
+    const uint8_t* areas = nullptr;
+    const uint8_t* testaments = nullptr;
+    const uint16_t* chapters = nullptr;
+    const uint16_t* verses = nullptr;
+    const uint16_t* difficulty = nullptr;
+    const uint32_t* textOffsets = nullptr;
+    const uint32_t* wordIndex = nullptr;
+    const CorpusWordSpan* wordSpans = nullptr;
+    const char* strings = nullptr;
+    uint64_t stringsSize = 0;
+
+    std::size_t verseCount() const { return header ? header->verseCount : 0; }
+    std::string label(uint32_t index) const;
+    std::string bookName(uint8_t id) const { return label(id); }
+    std::string areaName(uint8_t id) const { return label(header->bookCount + id); }
+    std::string testamentName(uint8_t id) const { return label(header->bookCount + header->areaCount + id); }
+    std::string text(std::size_t index) const;
+};
+
+// Validates an in-memory corpus image and fills `view`: the header, the
+// section bounds, and in one linear pass the text offsets, word spans and
+// label ids of every verse, so a damaged file is rejected rather than read
+// out of bounds. No strings are copied or parsed.
+bool OpenCorpusView(const void* data, std::size_t size, CorpusView& view);
+
+// Maps `foo.json` to `foo.bin`; any other path gets `.bin` appended.
+std::string BinaryCorpusPath(const std::string& jsonPath);
@@ -0,0 +1,149 @@
+#include "CorpusWriter.h"
+#include "Difficulty.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+// Python's json encoder with ensure_ascii=False only escapes the quote, the
+// backslash and C0 control characters; everything else is written as UTF-8.
+void appendJsonString(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (const char ch : text) {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        default:
+            if (c < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out.push_back(ch);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+template <typename T>
+void appendRaw(std::string& out, const T* values, std::size_t count) {
+    out.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+}
+
+bool writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return static_cast<bool>(file);
+}
+
+}
+
+bool WriteCorpusJson(const VerseStore& store, const std::string& path) {
+    std::string out;
+    out.reserve(store.size() * 320);
+    out += "[";
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        out += i == 0 ? "\n    {\n" : ",\n    {\n";
+        out += "        \"testament\": ";
+        appendJsonString(out, store.testamentNames()[store.testamentId(i)]);
+        out += ",\n        \"area\": ";
+        appendJsonString(out, store.areaNames()[store.areaId(i)]);
+        out += ",\n        \"book\": ";
+        appendJsonString(out, store.bookNames()[store.bookId(i)]);
+        out += ",\n        \"chapter\": ";
+        out += std::to_string(store.chapter(i));
+        out += ",\n        \"verse\": ";
+        out += std::to_string(store.verse(i));
+        out += ",\n        \"text\": ";
+        appendJsonString(out, store.text(i));
+        out += "\n    }";
+    }
+    out += store.size() == 0 ? "]" : "\n]";
+    return writeFile(path, out);
+}
+
+bool WriteCorpusBinary(const VerseStore& store, const std::string& path) {
+    const std::size_t n = store.size();
+
+    std::string pool;
+    std::vector<uint32_t> textOffsets;
+    textOffsets.reserve(n + 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        textOffsets.push_back(static_cast<uint32_t>(pool.size()));
+        pool += store.text(i);
+    }
+    textOffsets.push_back(static_cast<uint32_t>(pool.size()));
+
+    std::vector<CorpusLabel> labels;
+    for (const auto* names : {&store.bookNames(), &store.areaNames(), &store.testamentNames()}) {
+        for (const auto& name : *names) {
+            labels.push_back({static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(name.size())});
+            pool += name;
+        }
+    }
+
+    std::vector<uint8_t> books(n), areas(n), testaments(n);
+    std::vector<uint16_t> chapters(n), verses(n);
+    std::vector<uint16_t> difficulty = store.hasDifficulty() ? std::vector<uint16_t>(n)
+                                                             : ComputeDifficultyScores(store);
+    std::vector<uint32_t> wordIndex;
+    std::vector<CorpusWordSpan> wordSpans;
+    wordIndex.reserve(n + 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        wordIndex.push_back(static_cast<uint32_t>(wordSpans.size()));
+        wordSpans.insert(wordSpans.end(), store.wordSpans(i), store.wordSpans(i) + store.wordCount(i));
+        books[i] = store.bookId(i);
+        areas[i] = store.areaId(i);
+        testaments[i] = store.testamentId(i);
+        chapters[i] = store.chapter(i);
+        verses[i] = store.verse(i);
+        if (store.hasDifficulty()) difficulty[i] = store.difficulty(i);
+    }
+    wordIndex.push_back(static_cast<uint32_t>(wordSpans.size()));
+
+    std::string sections[kCorpusSectionCount];
+    appendRaw(sections[kCorpusLabels], labels.data(), labels.size());
+    appendRaw(sections[kCorpusBooks], books.data(), n);
+    appendRaw(sections[kCorpusAreas], areas.data(), n);
+    appendRaw(sections[kCorpusTestaments], testaments.data(), n);
+    appendRaw(sections[kCorpusChapters], chapters.data(), n);
+    appendRaw(sections[kCorpusVerses], verses.data(), n);
+    appendRaw(sections[kCorpusDifficulty], difficulty.data(), n);
+    appendRaw(sections[kCorpusTextOffsets], textOffsets.data(), textOffsets.size());
+    appendRaw(sections[kCorpusWordIndex], wordIndex.data(), wordIndex.size());
+    appendRaw(sections[kCorpusWordSpans], wordSpans.data(), wordSpans.size());
+    sections[kCorpusStrings] = std::move(pool);
+
+    CorpusHeader header = {};
+    std::memcpy(header.magic, kCorpusMagic, sizeof(kCorpusMagic));
+    header.version = kCorpusVersion;
+    header.verseCount = static_cast<uint32_t>(n);
+    header.bookCount = static_cast<uint32_t>(store.bookNames().size());
+    header.areaCount = static_cast<uint32_t>(store.areaNames().size());
+    header.testamentCount = static_cast<uint32_t>(store.testamentNames().size());
+
+    std::string body;
+    uint64_t offset = sizeof(CorpusHeader);
+    for (uint32_t id = 0; id < kCorpusSectionCount; ++id) {
+        const uint64_t padding = (8 - offset % 8) % 8;
+        body.append(static_cast<std::size_t>(padding), '\0');
+        offset += padding;
+        header.sections[id] = {offset, sections[id].size()};
+        body += sections[id];
+        offset += sections[id].size();
+    }
+
+    std::string out(reinterpret_cast<const char*>(&header), sizeof(header));
+    out += body;
+    return writeFile(path, out);
+}
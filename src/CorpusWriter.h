@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+#include "VerseStore.h"
+
+// Writes `store` as bible_sections.json, formatted exactly like
+// json.dump(..., ensure_ascii=False, indent=4) in tools/sort.py.
+bool WriteCorpusJson(const VerseStore& store, const std::string& path);
+
+// Writes `store` in the binary layout described in CorpusFormat.h.
+bool WriteCorpusBinary(const VerseStore& store, const std::string& path);
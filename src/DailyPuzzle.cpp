@@ -0,0 +1,98 @@
+#include "DailyPuzzle.h"
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+// Shared by every install; changing it reschedules every day.
+constexpr uint64_t kDailyKey = 0x6269626972626c65ULL;
+// Day numbers count from here, so the first cycle starts at launch.
+constexpr CalendarDate kFirstDay = {2025, 1, 1};
+
+bool isLeap(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+unsigned daysInMonth(int year, unsigned month) {
+    static const unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && isLeap(year) ? 29 : kDays[month - 1];
+}
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+}
+
+// Howard Hinnant's days_from_civil / civil_from_days: years are shifted to
+// start in March so the leap day falls at the end of the 400-year era.
+int64_t DaysFromCivil(const CalendarDate& date) {
+    const int64_t y = static_cast<int64_t>(date.year) - (date.month <= 2 ? 1 : 0);
+    const int64_t era = floorDiv(y, 400);
+    const int64_t yoe = y - era * 400;
+    const int64_t mp = (date.month + 9) % 12;
+    const int64_t doy = (153 * mp + 2) / 5 + date.day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+CalendarDate CivilFromDays(int64_t days) {
+    days += 719468;
+    const int64_t era = floorDiv(days, 146097);
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    CalendarDate date;
+    date.day = static_cast<unsigned>(doy - (153 * mp + 2) / 5 + 1);
+    date.month = static_cast<unsigned>(mp < 10 ? mp + 3 : mp - 9);
+    date.year = static_cast<int>(yoe + era * 400 + (date.month <= 2 ? 1 : 0));
+    return date;
+}
+
+bool ParseDate(std::string_view text, CalendarDate& date) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') return false;
+    int fields[3] = {0, 0, 0};
+    const std::size_t starts[3] = {0, 5, 8};
+    const std::size_t lengths[3] = {4, 2, 2};
+    for (int f = 0; f < 3; ++f) {
+        for (std::size_t i = 0; i < lengths[f]; ++i) {
+            const char c = text[starts[f] + i];
+            if (c < '0' || c > '9') return false;
+            fields[f] = fields[f] * 10 + (c - '0');
+        }
+    }
+    if (fields[1] < 1 || fields[1] > 12) return false;
+    if (fields[2] < 1 || static_cast<unsigned>(fields[2]) > daysInMonth(fields[0], fields[1])) return false;
+    date = {fields[0], static_cast<unsigned>(fields[1]), static_cast<unsigned>(fields[2])};
+    return true;
+}
+
+std::string FormatDate(const CalendarDate& date) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%04d-%02u-%02u", date.year, date.month, date.day);
+    return text;
+}
+
+CalendarDate Today() {
+    const std::time_t now = std::time(nullptr);
+    std::tm local = {};
+#if defined(_WIN32)
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return {local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1), static_cast<unsigned>(local.tm_mday)};
+}
+
+DailyPuzzle::DailyPuzzle(std::size_t verseCount)
+    : m_verseCount(verseCount) {}
+
+std::size_t DailyPuzzle::verseForDay(int64_t day) const {
+    if (m_verseCount == 0) return 0;
+    const int64_t n = static_cast<int64_t>(m_verseCount);
+    const int64_t index = day - DaysFromCivil(kFirstDay);
+    const int64_t cycle = floorDiv(index, n);
+    const FeistelPermutation order(m_verseCount, FeistelPermutation::Mix(kDailyKey ^ static_cast<uint64_t>(cycle)));
+    return static_cast<std::size_t>(order(static_cast<uint64_t>(index - cycle * n)));
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Permutation.h"
+
+// A proleptic Gregorian calendar date.
+struct CalendarDate {
+    int year = 1970;
+    unsigned month = 1;
+    unsigned day = 1;
+};
+
+// Days since 1970-01-01 and back, in constant time (no loops over years).
+int64_t DaysFromCivil(const CalendarDate& date);
+CalendarDate CivilFromDays(int64_t days);
+// Strict "YYYY-MM-DD"; rejects impossible dates such as 2023-02-29.
+bool ParseDate(std::string_view text, CalendarDate& date);
+std::string FormatDate(const CalendarDate& date);
+// The local calendar date right now.
+CalendarDate Today();
+
+// The verse of the day: day numbers index a fixed keyed permutation of the
+// store, so every install with the same corpus agrees on the schedule with
+// no server and no state, each lookup is O(1), and no verse repeats until
+// the whole corpus has been used. Later cycles reshuffle with a derived key.
+class DailyPuzzle {
+public:
+    explicit DailyPuzzle(std::size_t verseCount);
+
+    std::size_t verseForDay(int64_t day) const;
+    std::size_t verseFor(const CalendarDate& date) const { return verseForDay(DaysFromCivil(date)); }
+
+private:
+    std::size_t m_verseCount;
+};
@@ -0,0 +1,64 @@
+#include "Difficulty.h"
+#include "BibleData.h"
+#include "Scoring.h"
+#include <algorithm>
+#include <array>
+
+const char* DifficultyName(Difficulty tier) {
+    switch (tier) {
+    case Difficulty::Easy: return "easy";
+    case Difficulty::Hard: return "hard";
+    case Difficulty::Normal: break;
+    }
+    return "normal";
+}
+
+bool ParseDifficulty(std::string_view name, Difficulty& tier) {
+    for (const Difficulty candidate : {Difficulty::Easy, Difficulty::Normal, Difficulty::Hard}) {
+        if (name == DifficultyName(candidate)) {
+            tier = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<uint16_t> ComputeDifficultyScores(const VerseStore& store) {
+    std::vector<int> familiarity;
+    for (std::size_t b = 0; b < store.bookNames().size(); ++b) {
+        const uint8_t canonical = store.canonicalBook(static_cast<uint8_t>(b));
+        familiarity.push_back(canonical != kNoBook ? kBooks[canonical].familiarity : 0);
+    }
+
+    auto digitCode = [&store](std::size_t i) {
+        const auto digits = AnswerDigits(store.chapter(i), store.verse(i));
+        return digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+    };
+    std::vector<uint32_t> shared(10000, 0);
+    for (std::size_t i = 0; i < store.size(); ++i) ++shared[digitCode(i)];
+
+    std::vector<uint16_t> scores(store.size());
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        const int unfamiliar = (2 - familiarity[store.bookId(i)]) * 150;
+        const int shortness = std::clamp(40 - static_cast<int>(store.wordCount(i)), 0, 33) * 9;
+        int sharing = 0;
+        for (uint32_t n = shared[digitCode(i)]; n > 1 && sharing < 6; n >>= 1) ++sharing;
+        scores[i] = static_cast<uint16_t>(unfamiliar + shortness + sharing * 50);
+    }
+    return scores;
+}
+
+double DifficultyWeight(Difficulty tier, uint16_t score) {
+    switch (tier) {
+    case Difficulty::Easy: {
+        const double ease = kMaxDifficultyScore + 1.0 - std::min(score, kMaxDifficultyScore);
+        return ease * ease * ease;
+    }
+    case Difficulty::Hard: {
+        const double hardness = score + 1.0;
+        return hardness * hardness * hardness;
+    }
+    case Difficulty::Normal: break;
+    }
+    return 1.0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "VerseStore.h"
+
+// Verse selection modes. Normal is the uniform pick; Easy and Hard weight
+// verses by their difficulty score.
+enum class Difficulty {
+    Easy,
+    Normal,
+    Hard
+};
+constexpr int kDifficultyCount = 3;
+
+// Lower-case names used on command lines and in reports.
+const char* DifficultyName(Difficulty tier);
+bool ParseDifficulty(std::string_view name, Difficulty& tier);
+
+// How hard a verse is to place, from 0 to kMaxDifficultyScore. The sum of
+// three integer terms of up to ~300 each:
+//   - the book is less familiar (tools/books.tsv),
+//   - the text is short, so the reveal gives away fewer words,
+//   - many verses share its chapter:verse digits, so digit feedback alone
+//     does not single it out (log2 of that count).
+// Stored in bible_sections.bin; tools/sort.py computes the same integers.
+constexpr uint16_t kMaxDifficultyScore = 897;
+std::vector<uint16_t> ComputeDifficultyScores(const VerseStore& store);
+
+// Sampling weight of a verse with `score`: Easy falls off with the cube of
+// the score, Hard grows with it, Normal is flat.
+double DifficultyWeight(Difficulty tier, uint16_t score);
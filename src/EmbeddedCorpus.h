@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// bible_sections.bin compiled into the executable, for builds configured
+// with BIBIRBLE_EMBED_CORPUS. The definitions are generated at build time by
+// cmake/EmbedCorpus.cmake. The image lives in the program's read-only data,
+// so the OS pages it in on demand like a mapped file.
+const unsigned char* EmbeddedCorpusData();
+std::size_t EmbeddedCorpusSize();
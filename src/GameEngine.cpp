@@ -0,0 +1,50 @@
+#include "GameEngine.h"
+#include "Trace.h"
+
+GameEngine::GameEngine(const BibleData& data)
+    : m_data(data),
+      m_rng(std::random_device{}()) {
+    m_index.build(m_data.store());
+}
+
+void GameEngine::start() {
+    if (m_data.verseCount() == 0) return;
+    start(m_data.sampleVerse(m_difficulty, m_rng));
+}
+
+void GameEngine::start(std::size_t verseIndex) {
+    TRACE_SCOPE("GameEngine::start");
+    m_target = m_data.verseAt(verseIndex);
+    m_answer = EncodeAnswer(m_data.store(), verseIndex);
+    m_started = true;
+    m_status = GameStatus::Playing;
+    m_results.clear();
+    m_results.reserve(kMaxGuesses);
+    m_candidates.assign(m_data.verseCount(), true);
+    m_remaining = m_candidates.count();
+    for (int stage = 0; stage < kRevealStages; ++stage) {
+        m_data.getRevealedText(m_target, stage, m_reveals[stage]);
+    }
+}
+
+GuessResult GameEngine::submit(std::string_view book, std::string_view digits) {
+    TRACE_SCOPE("GameEngine::submit");
+    const ScoreCode guess = EncodeGuess(m_data.store(), book, digits);
+    const PackedFeedback feedback = Score(guess, m_answer);
+    const GuessResult result = GuessResult::Unpack(feedback);
+    if (isOver()) return result;
+
+    m_results.push_back(result);
+    m_index.narrow(m_candidates, guess, feedback);
+    m_remaining = m_candidates.count();
+    if (result.correct()) {
+        m_status = GameStatus::Won;
+    } else if (guessCount() >= kMaxGuesses) {
+        m_status = GameStatus::Lost;
+    }
+    return result;
+}
+
+GuessResult GameEngine::evaluate(std::string_view book, std::string_view digits) const {
+    return GuessResult::Unpack(Score(EncodeGuess(m_data.store(), book, digits), m_answer));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BibleData.h"
+#include "CandidateIndex.h"
+#include "Scoring.h"
+
+enum class GameStatus {
+    Playing,
+    Won,
+    Lost
+};
+
+// The rules of one Bibirble game, independent of any UI: the target verse,
+// how far the reveal has progressed, guess scoring and the win/loss state.
+// It also tracks which verses are still consistent with every guess so far.
+// The engine keeps a reference to `data`, which must outlive it.
+class GameEngine {
+public:
+    static constexpr int kMaxGuesses = 7;
+    static constexpr int kRevealStages = 8;
+
+    explicit GameEngine(const BibleData& data);
+
+    // Starts a new game on a random verse, or on the verse at `verseIndex`.
+    void start();
+    void start(std::size_t verseIndex);
+    // Reseeds the generator start() draws verses from. Engines are seeded
+    // from std::random_device; the same seed replays the same verse sequence.
+    void seed(uint64_t value) { m_rng.seed(value); }
+    // Selection mode used by start() without an index.
+    void setDifficulty(Difficulty tier) { m_difficulty = tier; }
+    Difficulty difficulty() const { return m_difficulty; }
+
+    // Scores a guess and advances the game. `digits` holds the two chapter
+    // digits followed by the two verse digits; any non-digit never matches.
+    // Returns the feedback without changing state if the game is over.
+    GuessResult submit(std::string_view book, std::string_view digits);
+
+    // Scores a guess against the target without advancing the game; see Score().
+    GuessResult evaluate(std::string_view book, std::string_view digits) const;
+
+    bool isStarted() const { return m_started; }
+    const Verse& target() const { return m_target; }
+    GameStatus status() const { return m_status; }
+    bool isOver() const { return m_status != GameStatus::Playing; }
+    int guessCount() const { return static_cast<int>(m_results.size()); }
+    const std::vector<GuessResult>& results() const { return m_results; }
+    // Verses whose feedback would match every guess submitted this game.
+    const VerseBitset& candidates() const { return m_candidates; }
+    std::size_t remainingCount() const { return m_remaining; }
+    // Masked verse text for `stage` in [0, kRevealStages), computed at start.
+    const std::string& revealText(int stage) const { return m_reveals[stage]; }
+
+private:
+    const BibleData& m_data;
+    std::mt19937_64 m_rng;
+    Difficulty m_difficulty = Difficulty::Normal;
+    CandidateIndex m_index;
+    VerseBitset m_candidates;
+    std::size_t m_remaining = 0;
+    Verse m_target;
+    ScoreCode m_answer;
+    bool m_started = false;
+    GameStatus m_status = GameStatus::Playing;
+    std::vector<GuessResult> m_results;
+    std::array<std::string, kRevealStages> m_reveals;
+};
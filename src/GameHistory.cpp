@@ -0,0 +1,299 @@
+#include "GameHistory.h"
+#include "ReferenceIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr char kLogMagic[8] = {'B', 'I', 'B', 'L', 'H', 'L', 'O', 'G'};
+constexpr char kSnapshotMagic[8] = {'B', 'I', 'B', 'L', 'H', 'S', 'N', 'P'};
+// Version 2 keys records by canonical book id instead of corpus label id.
+constexpr uint32_t kHistoryVersion = 2;
+
+struct LogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+// Followed by BookAccuracy[bookCount] and a uint64 FNV-1a of everything before it.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bookCount;
+    uint64_t logOffset;
+    uint64_t games;
+    uint64_t wins;
+    uint32_t currentStreak;
+    uint32_t bestStreak;
+    uint64_t guessHistogram[GameEngine::kMaxGuesses + 1];
+};
+
+static_assert(sizeof(LogHeader) == 16, "LogHeader must be tightly packed");
+static_assert(sizeof(BookAccuracy) == 8, "BookAccuracy must be tightly packed");
+
+uint64_t fnv1a(const std::string& bytes) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+bool loadSnapshot(const std::string& path, HistoryStats& stats, uint64_t& logOffset) {
+    std::string bytes;
+    if (!readFile(path, bytes) || bytes.size() < sizeof(SnapshotHeader) + sizeof(uint64_t)) return false;
+
+    SnapshotHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kHistoryVersion) {
+        return false;
+    }
+    const std::size_t bodySize = sizeof(header) + std::size_t{header.bookCount} * sizeof(BookAccuracy);
+    if (bytes.size() != bodySize + sizeof(uint64_t)) return false;
+    uint64_t checksum;
+    std::memcpy(&checksum, bytes.data() + bodySize, sizeof(checksum));
+    if (checksum != fnv1a(bytes.substr(0, bodySize))) return false;
+
+    stats.games = header.games;
+    stats.wins = header.wins;
+    stats.currentStreak = header.currentStreak;
+    stats.bestStreak = header.bestStreak;
+    std::copy(std::begin(header.guessHistogram), std::end(header.guessHistogram), stats.guessHistogram.begin());
+    stats.books.resize(header.bookCount);
+    std::memcpy(stats.books.data(), bytes.data() + sizeof(header), header.bookCount * sizeof(BookAccuracy));
+    logOffset = header.logOffset;
+    return true;
+}
+
+// Written beside the old snapshot and renamed over it, so a crash leaves
+// either the old or the new one.
+bool saveSnapshot(const std::string& path, const HistoryStats& stats, uint64_t logOffset) {
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kHistoryVersion;
+    header.bookCount = static_cast<uint32_t>(stats.books.size());
+    header.logOffset = logOffset;
+    header.games = stats.games;
+    header.wins = stats.wins;
+    header.currentStreak = stats.currentStreak;
+    header.bestStreak = stats.bestStreak;
+    std::copy(stats.guessHistogram.begin(), stats.guessHistogram.end(), header.guessHistogram);
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(stats.books.data()), stats.books.size() * sizeof(BookAccuracy));
+    const uint64_t checksum = fnv1a(bytes);
+    bytes.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) == 0) return true;
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+}
+
+GameRecord MakeGameRecord(const GameEngine& engine, const VerseStore& store, bool daily, int32_t day) {
+    GameRecord game;
+    game.day = day;
+    const std::size_t index = engine.target().id;
+    game.book = store.canonicalBook(store.bookId(index));
+    // The same key the ReferenceIndex sorts by, for every canonical book.
+    game.verse = ReferenceIndex::Pack(game.book, store.chapter(index), store.verse(index));
+    game.guesses = static_cast<uint8_t>(engine.guessCount());
+    game.won = engine.status() == GameStatus::Won ? 1 : 0;
+    game.flags = static_cast<uint8_t>(static_cast<uint8_t>(engine.difficulty()) | (daily ? GameRecord::kDaily : 0));
+    return game;
+}
+
+void HistoryStats::add(const GameRecord& game) {
+    ++games;
+    if (game.won) {
+        ++wins;
+        bestStreak = std::max(bestStreak, ++currentStreak);
+        ++guessHistogram[std::min<std::size_t>(game.guesses, GameEngine::kMaxGuesses)];
+    } else {
+        currentStreak = 0;
+        ++guessHistogram[0];
+    }
+    if (game.book == kNoBook) return;
+    if (game.book >= books.size()) books.resize(game.book + 1u);
+    ++books[game.book].plays;
+    books[game.book].wins += game.won ? 1 : 0;
+}
+
+GameHistory::~GameHistory() {
+    close();
+}
+
+bool GameHistory::open(const std::string& directory) {
+    close();
+    m_logPath = (fs::path(directory) / "history.log").string();
+    m_snapshotPath = (fs::path(directory) / "history.snap").string();
+    m_stats = HistoryStats();
+
+    std::error_code error;
+    uint64_t logSize = fs::exists(m_logPath, error) ? fs::file_size(m_logPath, error) : 0;
+    if (error) return false;
+
+    LogHeader header = {};
+    std::memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+    header.version = kHistoryVersion;
+    header.recordSize = sizeof(GameRecord);
+
+    if (logSize < sizeof(LogHeader)) {
+        // New, or never got past its header.
+        std::ofstream file(m_logPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!file) return false;
+        logSize = sizeof(header);
+    }
+
+    std::ifstream file(m_logPath, std::ios::binary);
+    LogHeader existing;
+    if (!file.read(reinterpret_cast<char*>(&existing), sizeof(existing)) ||
+        std::memcmp(&existing, &header, sizeof(header)) != 0) {
+        return false;
+    }
+
+    // Cut off a record torn by a crash mid-append so later ones stay aligned.
+    const uint64_t whole = sizeof(LogHeader) + (logSize - sizeof(LogHeader)) / sizeof(GameRecord) * sizeof(GameRecord);
+    if (whole != logSize) {
+        file.close();
+        fs::resize_file(m_logPath, whole, error);
+        if (error) return false;
+        file.open(m_logPath, std::ios::binary);
+        logSize = whole;
+    }
+
+    uint64_t offset = 0;
+    const bool snapshot = loadSnapshot(m_snapshotPath, m_stats, offset) && offset >= sizeof(LogHeader) &&
+                          offset <= logSize && (offset - sizeof(LogHeader)) % sizeof(GameRecord) == 0;
+    if (!snapshot) {
+        m_stats = HistoryStats();
+        offset = sizeof(LogHeader);
+    }
+
+    // Replay only the tail the snapshot does not cover.
+    std::vector<GameRecord> tail(static_cast<std::size_t>((logSize - offset) / sizeof(GameRecord)));
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tail.size() * sizeof(GameRecord)))) {
+        return false;
+    }
+    for (const GameRecord& game : tail) m_stats.add(game);
+    file.close();
+
+    m_log = std::fopen(m_logPath.c_str(), "ab");
+    if (!m_log) return false;
+    m_written = m_stats;
+    m_logSize = logSize;
+    // The writer compacts first thing if the tail has grown long or the
+    // snapshot was unusable.
+    m_sinceSnapshot = snapshot ? static_cast<uint32_t>(tail.size()) : kCompactInterval;
+    m_pending.clear();
+    m_stalled = false;
+    m_stopping = false;
+    m_writeFailed.store(false, std::memory_order_relaxed);
+    m_writer = std::thread([this]() { writerLoop(); });
+    return true;
+}
+
+void GameHistory::record(const GameRecord& game) {
+    m_stats.add(game);
+    if (!isOpen()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(game);
+        m_stalled = false;
+    }
+    m_wake.notify_one();
+}
+
+void GameHistory::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return (m_pending.empty() || m_stalled) && !m_writing; });
+}
+
+void GameHistory::close() {
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+    if (m_log) {
+        std::fclose(m_log);
+        m_log = nullptr;
+    }
+}
+
+void GameHistory::writerLoop() {
+    if (m_sinceSnapshot >= kCompactInterval && saveSnapshot(m_snapshotPath, m_written, m_logSize)) {
+        m_sinceSnapshot = 0;
+    }
+    std::vector<GameRecord> batch;
+    for (;;) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_writing = false;
+            if (m_pending.empty() || m_stalled) m_idle.notify_all();
+            m_wake.wait(lock, [this]() { return m_stopping || (!m_pending.empty() && !m_stalled); });
+            if (m_pending.empty()) return;
+            stopping = m_stopping;
+            batch.swap(m_pending);
+            m_writing = true;
+        }
+
+        // Everything queued since the last wake-up goes out in one write.
+        if (!m_log) m_log = std::fopen(m_logPath.c_str(), "ab");
+        const bool complete = m_log && std::fwrite(batch.data(), sizeof(GameRecord), batch.size(), m_log) == batch.size() &&
+                              std::fflush(m_log) == 0;
+        if (!complete) {
+            // fwrite only counts what it buffered, so none of the batch is
+            // known to be on disk. Drop the stream with whatever it still
+            // holds, cut the log back to its size before the write and queue
+            // the whole batch again, ahead of anything recorded meanwhile.
+            if (m_log) std::fclose(m_log);
+            std::error_code error;
+            fs::resize_file(m_logPath, m_logSize, error);
+            m_log = std::fopen(m_logPath.c_str(), "ab");
+            m_writeFailed.store(true, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.insert(m_pending.begin(), batch.begin(), batch.end());
+            m_stalled = true;
+            batch.clear();
+            if (stopping) return;
+            continue;
+        }
+        for (const GameRecord& game : batch) m_written.add(game);
+        m_logSize += batch.size() * sizeof(GameRecord);
+        m_sinceSnapshot += static_cast<uint32_t>(batch.size());
+        batch.clear();
+
+        if (m_sinceSnapshot >= kCompactInterval && saveSnapshot(m_snapshotPath, m_written, m_logSize)) {
+            m_sinceSnapshot = 0;
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BookTable.h"
+#include "Difficulty.h"
+#include "GameEngine.h"
+
+// One finished game, stored verbatim in the history log.
+struct GameRecord {
+    static constexpr uint8_t kDaily = 0x4;
+
+    int32_t day = 0;        // DaysFromCivil of the local date the game ended
+    // The answer as ReferenceIndex::Pack(book, chapter, verse), and its book,
+    // both by canonical book id (BookTable.h) so that records outlive any
+    // rebuild of the corpus. kNoBook for a book the table does not know.
+    uint32_t verse = 0;
+    uint8_t book = kNoBook;
+    uint8_t guesses = 0;    // guesses used, 1..GameEngine::kMaxGuesses
+    uint8_t won = 0;
+    uint8_t flags = 0;      // Difficulty in bits 0-1, kDaily
+    uint32_t reserved = 0;
+
+    Difficulty difficulty() const { return static_cast<Difficulty>(flags & 0x3); }
+    bool daily() const { return (flags & kDaily) != 0; }
+};
+
+static_assert(sizeof(GameRecord) == 16, "GameRecord must be tightly packed");
+
+// Builds the record for a finished game.
+GameRecord MakeGameRecord(const GameEngine& engine, const VerseStore& store, bool daily, int32_t day);
+
+struct BookAccuracy {
+    uint32_t plays = 0;
+    uint32_t wins = 0;
+};
+
+// Aggregates over every recorded game; small and of fixed size per book, so
+// a snapshot of it replaces replaying the whole log.
+struct HistoryStats {
+    uint64_t games = 0;
+    uint64_t wins = 0;
+    // Consecutive wins ending with the latest game, and the longest such run.
+    uint32_t currentStreak = 0;
+    uint32_t bestStreak = 0;
+    // [0] counts lost games, [k] games won with the k-th guess.
+    std::array<uint64_t, GameEngine::kMaxGuesses + 1> guessHistogram = {};
+    // Indexed by canonical book id; grows as books are seen.
+    std::vector<BookAccuracy> books;
+
+    void add(const GameRecord& game);
+};
+
+// Game results kept in two files in one directory:
+//
+//   history.log   header, then one GameRecord per finished game, append-only
+//   history.snap  HistoryStats as of a byte offset into the log, checksummed
+//
+// open() reads the snapshot and only the log records written after it, so
+// start-up cost does not grow with the history. record() updates the stats
+// at once and hands the record to a writer thread, which appends it with one
+// buffered write and rewrites the snapshot every kCompactInterval records.
+// The log is never rewritten: a missing or damaged snapshot is rebuilt by
+// replaying it, and a torn record from an interrupted write is cut off.
+class GameHistory {
+public:
+    static constexpr uint32_t kCompactInterval = 64;
+
+    GameHistory() = default;
+    ~GameHistory();
+
+    GameHistory(const GameHistory&) = delete;
+    GameHistory& operator=(const GameHistory&) = delete;
+
+    // Loads the history kept in `directory`, creating the log if needed.
+    // Returns false (and records nothing) when the log cannot be used.
+    bool open(const std::string& directory);
+    bool isOpen() const { return m_writer.joinable(); }
+
+    void record(const GameRecord& game);
+    // Blocks until every recorded game has been written.
+    void flush();
+
+    // Owned by the thread calling record(); the writer keeps its own copy.
+    const HistoryStats& stats() const { return m_stats; }
+    // Whether appending to the log has failed. Records that did not make it
+    // stay queued and are retried when the next game is recorded.
+    bool writeFailed() const { return m_writeFailed.load(std::memory_order_relaxed); }
+
+private:
+    void writerLoop();
+    void close();
+
+    std::string m_logPath;
+    std::string m_snapshotPath;
+    HistoryStats m_stats;
+
+    // Writer thread state; m_log may be reopened after a failed write.
+    std::FILE* m_log = nullptr;
+    HistoryStats m_written;
+    uint64_t m_logSize = 0;
+    uint32_t m_sinceSnapshot = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::vector<GameRecord> m_pending;
+    bool m_writing = false;
+    // Set after a failed append; the writer waits for new records before retrying.
+    bool m_stalled = false;
+    std::atomic<bool> m_writeFailed{false};
+    bool m_stopping = false;
+    std::thread m_writer;
+};
@@ -1,8 +1,44 @@
 #include "GameRow.h"
 
-GameRow::GameRow(wxWindow* parent, const wxArrayString& books)
-    : wxPanel(parent) {
-    SetupUi(books);
+namespace {
+
+int DigitValue(const wxTextCtrl* edit) {
+    const wxString value = edit->GetValue();
+    if (value.length() != 1 || value[0] < '0' || value[0] > '9') return -1;
+    return static_cast<int>(value[0].GetValue() - '0');
+}
+
+// Two typed digits as a number, or -1 while either box is empty or not a digit.
+int TwoDigits(const wxTextCtrl* tens, const wxTextCtrl* units) {
+    const int a = DigitValue(tens);
+    const int b = DigitValue(units);
+    return a < 0 || b < 0 ? -1 : a * 10 + b;
+}
+
+}
+
+BookChoices::BookChoices(const BibleData& data) {
+    const std::vector<std::string>& books = data.getAllBooks();
+    labels.Alloc(books.size());
+    keys.reserve(books.size());
+    for (const std::string& book : books) {
+        const uint8_t canonical = FindBookId(book);
+        const std::string_view label = canonical != kNoBook ? kBooks[canonical].display : std::string_view(book);
+        labels.Add(wxString::FromUTF8(label.data(), label.size()));
+        keys.push_back(book);
+    }
+}
+
+int BookChoices::find(const std::string& key) const {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == key) return static_cast<int>(i);
+    }
+    return wxNOT_FOUND;
+}
+
+GameRow::GameRow(wxWindow* parent, const BookChoices& books, const BibleData& data)
+    : wxPanel(parent), m_books(books), m_data(data) {
+    SetupUi();
     setDisabled(true);
 }
 wxTextCtrl* GameRow::CreateDigitInput() {
@@ -13,13 +49,19 @@ wxTextCtrl* GameRow::CreateDigitInput() {
     edit->SetFont(font);
     return edit;
 }
-void GameRow::SetupUi(const wxArrayString& books) {
+void GameRow::Populate() {
+    if (m_populated) return;
+    m_bookSelect->Set(m_books.labels);
+    m_populated = true;
+}
+
+void GameRow::SetupUi() {
     wxBoxSizer* layout = new wxBoxSizer(wxHORIZONTAL);
     layout->SetMinSize(wxSize(-1, 50));
     
     // Book Dropdown
     m_bookSelect = new wxComboBox(this, wxID_ANY, "", wxDefaultPosition, 
-                                   wxSize(150, -1), books, wxCB_READONLY);
+                                   wxSize(150, -1), 0, nullptr, wxCB_READONLY);
     m_bookSelect->SetMinSize(wxSize(150, 40));
     m_bookSelect->Bind(wxEVT_COMBOBOX, [this](wxCommandEvent& event) {
         if (m_isBookLocked) {
@@ -27,6 +69,7 @@ void GameRow::SetupUi(const wxArrayString& books) {
             return;
         }
         m_lockedBookSelection = m_bookSelect->GetStringSelection();
+        UpdateRangeWarning();
         event.Skip();
     });
     layout->Add(m_bookSelect, 2, wxEXPAND | wxALL, 4);
@@ -50,6 +93,13 @@ void GameRow::SetupUi(const wxArrayString& books) {
     
     m_v2 = CreateDigitInput();
     layout->Add(m_v2, 0, wxEXPAND | wxALL, 4);
+
+    for (wxTextCtrl* edit : {m_c1, m_c2, m_v1, m_v2}) {
+        edit->Bind(wxEVT_TEXT, [this](wxCommandEvent& event) {
+            UpdateRangeWarning();
+            event.Skip();
+        });
+    }
     
     SetSizer(layout);
 }
@@ -58,6 +108,7 @@ void GameRow::SetupUi(const wxArrayString& books) {
 
 void GameRow::setDisabled(bool disabled) {
     if (!disabled) {
+        Populate();
         m_isBookLocked = false;
         m_lockedBookSelection = m_bookSelect->GetStringSelection();
     }
@@ -83,7 +134,9 @@ bool GameRow::isComplete() const {
 }
 
 std::string GameRow::getBook() const {
-    return std::string(m_bookSelect->GetStringSelection().mb_str());
+    const int selection = m_bookSelect->GetSelection();
+    return selection >= 0 && static_cast<std::size_t>(selection) < m_books.keys.size() ? m_books.keys[selection]
+                                                                                      : std::string();
 }
 
 std::vector<std::string> GameRow::getDigits() const {
@@ -95,48 +148,71 @@ std::vector<std::string> GameRow::getDigits() const {
     };
 }
 
-void GameRow::setBookColor(const std::string& color) {
+void GameRow::ApplyFeedbackColors(wxWindow* control, Feedback feedback) {
     wxColour bgColor;
     wxColour fgColor(*wxBLACK);
     
-    if (color == "green") {
+    switch (feedback) {
+    case Feedback::Green:
         bgColor = *wxGREEN;
         fgColor = *wxWHITE;
-    } else if (color == "yellow") {
+        break;
+    case Feedback::Yellow:
         bgColor = *wxYELLOW;
-        fgColor = *wxBLACK;
-    } else {
+        break;
+    case Feedback::Gray:
         bgColor = *wxLIGHT_GREY;
-        fgColor = *wxBLACK;
+        break;
     }
     
-    m_bookSelect->SetBackgroundColour(bgColor);
-    m_bookSelect->SetForegroundColour(fgColor);
-    m_bookSelect->Refresh();
+    control->SetBackgroundColour(bgColor);
+    control->SetForegroundColour(fgColor);
+    control->Refresh();
 }
 
-void GameRow::setDigitColors(const std::vector<std::string>& colors) {
-    std::vector<wxTextCtrl*> edits = {m_c1, m_c2, m_v1, m_v2};
-    
-    for (size_t i = 0; i < colors.size() && i < edits.size(); ++i) {
-        wxColour bgColor;
-        wxColour fgColor(*wxBLACK);
-        
-        if (colors[i] == "green") {
-            bgColor = *wxGREEN;
-            fgColor = *wxWHITE;
-        } else if (colors[i] == "yellow") {
-            bgColor = *wxYELLOW;
-            fgColor = *wxBLACK;
-        } else {
-            bgColor = *wxLIGHT_GREY;
-            fgColor = *wxBLACK;
+void GameRow::setBookColor(Feedback feedback) {
+    ApplyFeedbackColors(m_bookSelect, feedback);
+}
+
+void GameRow::setDigitColors(const std::array<Feedback, 4>& feedback) {
+    wxTextCtrl* const edits[] = {m_c1, m_c2, m_v1, m_v2};
+    for (std::size_t i = 0; i < feedback.size(); ++i) {
+        ApplyFeedbackColors(edits[i], feedback[i]);
+    }
+}
+
+void GameRow::SetWarning(wxTextCtrl* first, wxTextCtrl* second, const wxString& message) {
+    const wxColour colour = message.empty() ? wxNullColour : *wxRED;
+    for (wxTextCtrl* edit : {first, second}) {
+        edit->SetForegroundColour(colour);
+        edit->SetToolTip(message);
+        edit->Refresh();
+    }
+}
+
+void GameRow::UpdateRangeWarning() {
+    if (m_isBookLocked) return;
+
+    wxString chapterWarning, verseWarning;
+    const std::string book = getBook();
+    const uint8_t id = m_data.store().findBook(book);
+    const int chapter = TwoDigits(m_c1, m_c2);
+    const int verse = TwoDigits(m_v1, m_v2);
+    if (id != kNoLabel && chapter >= 0) {
+        const ReferenceIndex& references = m_data.references();
+        // The dropdown label, e.g. "1 Samuel" rather than the key "1samuel".
+        const wxString name = m_bookSelect->GetStringSelection();
+        const unsigned chapters = references.maxChapter(id);
+        if (chapter < 1 || static_cast<unsigned>(chapter) > chapters) {
+            chapterWarning = wxString::Format("%s has %u chapters", name, chapters);
+        } else if (verse >= 0 && !references.inRange(id, chapter, verse)) {
+            // maxVerse is the highest verse number stored, not a count.
+            verseWarning = wxString::Format("%s %d: stored verses only go up to %u", name, chapter,
+                                            references.maxVerse(id, chapter));
         }
-        
-        edits[i]->SetBackgroundColour(bgColor);
-        edits[i]->SetForegroundColour(fgColor);
-        edits[i]->Refresh();
     }
+    SetWarning(m_c1, m_c2, chapterWarning);
+    SetWarning(m_v1, m_v2, verseWarning);
 }
 
 std::vector<wxTextCtrl*> GameRow::GetDigitCtrls() {
@@ -158,3 +234,32 @@ void GameRow::lockSubmitted() {
     m_v1->SetEditable(false);
     m_v2->SetEditable(false);
 }
+
+void GameRow::reset() {
+    m_isBookLocked = false;
+    m_bookSelect->SetSelection(wxNOT_FOUND);
+    m_lockedBookSelection.clear();
+    m_bookSelect->SetBackgroundColour(wxNullColour);
+    m_bookSelect->SetForegroundColour(wxNullColour);
+    m_bookSelect->Refresh();
+    for (wxTextCtrl* edit : {m_c1, m_c2, m_v1, m_v2}) {
+        edit->Clear();
+        edit->SetBackgroundColour(wxNullColour);
+        edit->SetForegroundColour(wxNullColour);
+        edit->UnsetToolTip();
+        edit->Refresh();
+    }
+    setDisabled(true);
+}
+
+void GameRow::setGuess(const std::string& book, const std::string& digits) {
+    if (m_isBookLocked || digits.size() != 4) return;
+    Populate();
+    m_bookSelect->SetSelection(m_books.find(book));
+    m_lockedBookSelection = m_bookSelect->GetStringSelection();
+    wxTextCtrl* const edits[] = {m_c1, m_c2, m_v1, m_v2};
+    for (std::size_t i = 0; i < digits.size(); ++i) {
+        edits[i]->SetValue(wxString(digits[i]));
+    }
+    UpdateRangeWarning();
+}
@@ -3,23 +3,48 @@
 #include <wx/wx.h>
 #include <vector>
 #include <string>
+#include "BibleData.h"
+#include "Scoring.h"
+
+// The book dropdown's contents, built once and shared by every row: display
+// labels in canonical order and the corpus key behind each.
+struct BookChoices {
+    wxArrayString labels;
+    std::vector<std::string> keys;
+
+    explicit BookChoices(const BibleData& data);
+    // Index of corpus key `key`, or wxNOT_FOUND.
+    int find(const std::string& key) const;
+};
 
 class GameRow : public wxPanel {
 public:
-    explicit GameRow(wxWindow* parent, const wxArrayString& books);
+    // `books` and `data` must outlive the row; `data` supplies the chapter
+    // and verse ranges used to flag typed references that do not exist.
+    GameRow(wxWindow* parent, const BookChoices& books, const BibleData& data);
     
     void setDisabled(bool disabled);
     bool isComplete() const;
     
+    // Corpus key of the selected book, or empty.
     std::string getBook() const;
     std::vector<std::string> getDigits() const;
     std::vector<wxTextCtrl*> GetDigitCtrls();
     
-    void setBookColor(const std::string& color);
-    void setDigitColors(const std::vector<std::string>& colors);
+    void setBookColor(Feedback feedback);
+    void setDigitColors(const std::array<Feedback, 4>& feedback);
     void lockSubmitted();
+    // Clears the selection, digits and feedback colours for a new game.
+    void reset();
+    // Fills the row with a suggested guess; `digits` is "CCVV".
+    void setGuess(const std::string& book, const std::string& digits);
 
 private:
+    const BookChoices& m_books;
+    const BibleData& m_data;
+    // The dropdown is filled when the row is first played, so rows that are
+    // never reached cost no native list items.
+    bool m_populated = false;
     wxComboBox* m_bookSelect;
     wxTextCtrl* m_c1;
     wxTextCtrl* m_c2;
@@ -28,6 +53,12 @@ private:
     bool m_isBookLocked = false;
     wxString m_lockedBookSelection;
     
-    void SetupUi(const wxArrayString& books);
+    void SetupUi();
+    void Populate();
     wxTextCtrl* CreateDigitInput();
+    // Marks the chapter or verse digits when the selected book has no such
+    // chapter or verse. Only a warning: any digits may still be guessed.
+    void UpdateRangeWarning();
+    static void SetWarning(wxTextCtrl* first, wxTextCtrl* second, const wxString& message);
+    static void ApplyFeedbackColors(wxWindow* control, Feedback feedback);
 };
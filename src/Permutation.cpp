@@ -0,0 +1,42 @@
+#include "Permutation.h"
+
+FeistelPermutation::FeistelPermutation(uint64_t size, uint64_t key)
+    : m_size(size), m_key(key) {
+    int bits = 2;
+    while (bits < 64 && (uint64_t(1) << bits) < size) bits += 2;
+    m_halfBits = bits / 2;
+    m_halfMask = (uint64_t(1) << m_halfBits) - 1;
+    uint64_t state = key;
+    for (uint64_t& roundKey : m_roundKeys) {
+        state = Mix(state);
+        roundKey = state;
+    }
+}
+
+uint64_t FeistelPermutation::Mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+uint64_t FeistelPermutation::encrypt(uint64_t value) const {
+    uint64_t left = value >> m_halfBits;
+    uint64_t right = value & m_halfMask;
+    for (const uint64_t roundKey : m_roundKeys) {
+        const uint64_t mixed = left ^ (Mix(right ^ roundKey) & m_halfMask);
+        left = right;
+        right = mixed;
+    }
+    return (left << m_halfBits) | right;
+}
+
+uint64_t FeistelPermutation::operator()(uint64_t index) const {
+    // The network permutes the whole power-of-two domain; walking the cycle
+    // from `index` until it lands below size() restricts it to [0, size).
+    // The domain is under four times size(), so that takes few steps.
+    if (m_size <= 1) return 0;
+    uint64_t value = encrypt(index);
+    while (value >= m_size) value = encrypt(value);
+    return value;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// A keyed pseudo-random permutation of [0, size) evaluated point-wise in O(1)
+// time and memory: a balanced four-round Feistel network over the smallest
+// even power of two covering `size`, with cycle walking to stay in range.
+// The same (size, key) gives the same permutation on every platform.
+class FeistelPermutation {
+public:
+    FeistelPermutation() = default;
+    FeistelPermutation(uint64_t size, uint64_t key);
+
+    uint64_t size() const { return m_size; }
+    uint64_t key() const { return m_key; }
+    // Image of `index`, which must be below size().
+    uint64_t operator()(uint64_t index) const;
+
+    // SplitMix64 finalizer; also used to derive keys.
+    static uint64_t Mix(uint64_t value);
+
+private:
+    static constexpr int kRounds = 4;
+
+    uint64_t encrypt(uint64_t value) const;
+
+    uint64_t m_size = 0;
+    uint64_t m_key = 0;
+    int m_halfBits = 1;
+    uint64_t m_halfMask = 1;
+    uint64_t m_roundKeys[kRounds] = {};
+};
@@ -0,0 +1,111 @@
+#include "ReferenceIndex.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t kNotIndexed = UINT32_MAX;
+
+}
+
+void ReferenceIndex::build(const VerseStore& store) {
+    const std::size_t n = store.size();
+    // Canonical books take their BookTable id; the rest follow in store order
+    // while keys last.
+    m_bookKeys.assign(store.bookNames().size(), kNoKey);
+    unsigned nextKey = kBookCount;
+    for (std::size_t b = 0; b < m_bookKeys.size(); ++b) {
+        const uint8_t canonical = store.canonicalBook(static_cast<uint8_t>(b));
+        if (canonical != kNoBook) {
+            m_bookKeys[b] = canonical;
+        } else if (nextKey < kNoKey) {
+            m_bookKeys[b] = static_cast<uint8_t>(nextKey++);
+        }
+    }
+
+    // Key in the high half and store index in the low half, so one plain sort
+    // orders by reference and keeps duplicates in store order.
+    std::vector<uint64_t> entries;
+    entries.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint8_t key = m_bookKeys[store.bookId(i)];
+        if (key == kNoKey || store.chapter(i) > kMaxNumber || store.verse(i) > kMaxNumber) continue;
+        entries.push_back(uint64_t{Pack(key, store.chapter(i), store.verse(i))} << 32 | i);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    m_keys.resize(entries.size());
+    m_order.resize(entries.size());
+    m_position.assign(n, kNotIndexed);
+    m_maxChapter.assign(nextKey, 0);
+    for (std::size_t p = 0; p < entries.size(); ++p) {
+        const uint32_t i = static_cast<uint32_t>(entries[p]);
+        m_keys[p] = static_cast<uint32_t>(entries[p] >> 32);
+        m_order[p] = i;
+        m_position[i] = static_cast<uint32_t>(p);
+        uint16_t& chapters = m_maxChapter[m_keys[p] >> 24];
+        chapters = std::max(chapters, store.chapter(i));
+    }
+
+    // Chapter tables are laid out book after book, each with a slot for chapter 0.
+    m_chapterBase.assign(m_maxChapter.size(), 0);
+    uint32_t slots = 0;
+    for (std::size_t b = 0; b < m_maxChapter.size(); ++b) {
+        m_chapterBase[b] = slots;
+        slots += m_maxChapter[b] + 1u;
+    }
+    m_maxVerse.assign(slots, 0);
+    for (const uint32_t key : m_keys) {
+        uint16_t& verses = m_maxVerse[m_chapterBase[key >> 24] + (key >> 12 & kMaxNumber)];
+        verses = std::max(verses, static_cast<uint16_t>(key & kMaxNumber));
+    }
+}
+
+std::size_t ReferenceIndex::find(uint8_t book, unsigned chapter, unsigned verse) const {
+    const uint8_t id = bookKey(book);
+    if (id == kNoKey || chapter > kMaxNumber || verse > kMaxNumber) return kNoVerse;
+    const uint32_t key = Pack(id, chapter, verse);
+    const auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+    if (it == m_keys.end() || *it != key) return kNoVerse;
+    return m_order[static_cast<std::size_t>(it - m_keys.begin())];
+}
+
+VerseRange ReferenceIndex::book(uint8_t book) const {
+    const uint8_t key = bookKey(book);
+    if (key == kNoKey) return VerseRange();
+    return span(Pack(key, 0, 0), Pack(key, kMaxNumber, kMaxNumber));
+}
+
+VerseRange ReferenceIndex::chapter(uint8_t book, unsigned chapter) const {
+    const uint8_t key = bookKey(book);
+    if (key == kNoKey || chapter > kMaxNumber) return VerseRange();
+    return span(Pack(key, chapter, 0), Pack(key, chapter, kMaxNumber));
+}
+
+VerseRange ReferenceIndex::span(uint32_t first, uint32_t last) const {
+    if (first > last) return VerseRange();
+    const auto begin = std::lower_bound(m_keys.begin(), m_keys.end(), first);
+    const auto end = std::upper_bound(begin, m_keys.end(), last);
+    return positions(static_cast<std::size_t>(begin - m_keys.begin()), static_cast<std::size_t>(end - m_keys.begin()));
+}
+
+std::size_t ReferenceIndex::neighbour(std::size_t index, std::ptrdiff_t offset) const {
+    if (index >= m_position.size() || m_position[index] == kNotIndexed) return kNoVerse;
+    const std::ptrdiff_t p = static_cast<std::ptrdiff_t>(m_position[index]) + offset;
+    if (p < 0 || p >= static_cast<std::ptrdiff_t>(m_order.size())) return kNoVerse;
+    return m_order[static_cast<std::size_t>(p)];
+}
+
+unsigned ReferenceIndex::maxChapter(uint8_t book) const {
+    const uint8_t key = bookKey(book);
+    return key < m_maxChapter.size() ? m_maxChapter[key] : 0;
+}
+
+unsigned ReferenceIndex::maxVerse(uint8_t book, unsigned chapter) const {
+    const uint8_t key = bookKey(book);
+    if (key >= m_maxChapter.size() || chapter > m_maxChapter[key]) return 0;
+    return m_maxVerse[m_chapterBase[key] + chapter];
+}
+
+VerseRange ReferenceIndex::positions(std::size_t first, std::size_t last) const {
+    return VerseRange(m_order.data() + first, m_order.data() + last);
+}
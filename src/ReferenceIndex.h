@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "VerseStore.h"
+
+// Store indices of a run of verses in reference order.
+class VerseRange {
+public:
+    VerseRange() = default;
+    VerseRange(const uint32_t* begin, const uint32_t* end) : m_begin(begin), m_end(end) {}
+
+    const uint32_t* begin() const { return m_begin; }
+    const uint32_t* end() const { return m_end; }
+    std::size_t size() const { return static_cast<std::size_t>(m_end - m_begin); }
+    bool empty() const { return m_begin == m_end; }
+
+private:
+    const uint32_t* m_begin = nullptr;
+    const uint32_t* m_end = nullptr;
+};
+
+// Every verse of a store sorted by a packed (book, chapter, verse) key in
+// biblical order, so a reference is found by binary search and a chapter, a
+// book or any span between two references is one contiguous run. Also keeps, per book, the
+// highest chapter and, per chapter, the highest verse, for validating typed
+// references without a search.
+class ReferenceIndex {
+public:
+    static constexpr std::size_t kNoVerse = static_cast<std::size_t>(-1);
+    // Chapters and verses above this cannot be packed and are not indexed.
+    static constexpr unsigned kMaxNumber = 0xFFF;
+
+    // Book key in bits 24-31, chapter in bits 12-23, verse in bits 0-11. The
+    // book key is the canonical id (BookTable.h); books the table does not
+    // know follow revelation in store order (see bookKey).
+    static uint32_t Pack(uint8_t book, unsigned chapter, unsigned verse) {
+        return uint32_t{book} << 24 | (chapter & kMaxNumber) << 12 | (verse & kMaxNumber);
+    }
+
+    void build(const VerseStore& store);
+    std::size_t size() const { return m_keys.size(); }
+
+    // Book key of store book id `book`, or kNoKey if it is not indexed. All
+    // other queries take store book ids and convert them with this.
+    static constexpr uint8_t kNoKey = 0xFF;
+    uint8_t bookKey(uint8_t book) const { return book < m_bookKeys.size() ? m_bookKeys[book] : kNoKey; }
+
+    // Store index of book chapter:verse, or kNoVerse. A verse stored as
+    // several sections gives the first; ranges include all of them.
+    std::size_t find(uint8_t book, unsigned chapter, unsigned verse) const;
+    VerseRange book(uint8_t book) const;
+    VerseRange chapter(uint8_t book, unsigned chapter) const;
+    // Verses from `first` through `last` inclusive, both given as Pack keys
+    // of book keys; the ends need not exist.
+    VerseRange span(uint32_t first, uint32_t last) const;
+
+    // The verse `offset` places from store index `index` in reference order,
+    // crossing chapter and book boundaries, or kNoVerse past either end.
+    std::size_t neighbour(std::size_t index, std::ptrdiff_t offset) const;
+
+    // 0 for a book id or chapter that has no verses.
+    unsigned maxChapter(uint8_t book) const;
+    // The highest verse number stored for the chapter; books may skip
+    // numbers, so this is not a verse count.
+    unsigned maxVerse(uint8_t book, unsigned chapter) const;
+    // Whether the chapter and verse are in range for the book. Books may
+    // skip verse numbers, so this does not promise find() succeeds.
+    bool inRange(uint8_t book, unsigned chapter, unsigned verse) const {
+        return chapter >= 1 && verse >= 1 && verse <= maxVerse(book, chapter);
+    }
+
+private:
+    VerseRange positions(std::size_t first, std::size_t last) const;
+
+    std::vector<uint32_t> m_keys;      // sorted Pack keys
+    std::vector<uint32_t> m_order;     // store index of each key
+    std::vector<uint32_t> m_position;  // position in m_keys of each store index
+    std::vector<uint8_t> m_bookKeys;        // per store book id
+    std::vector<uint16_t> m_maxChapter;     // per book key
+    std::vector<uint32_t> m_chapterBase;    // per book key, into m_maxVerse
+    std::vector<uint16_t> m_maxVerse;       // [m_chapterBase[key] + chapter]
+};
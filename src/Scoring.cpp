@@ -0,0 +1,296 @@
+#include "Scoring.h"
+#include "BibleData.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define BIBIRBLE_SCORING_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+bool GuessResult::correct() const {
+    return pack() == kSolvedFeedback;
+}
+
+PackedFeedback GuessResult::pack() const {
+    unsigned packed = 0;
+    for (std::size_t i = digits.size(); i-- > 0;) {
+        packed = packed * 3 + static_cast<unsigned>(digits[i]);
+    }
+    return static_cast<PackedFeedback>(packed * 3 + static_cast<unsigned>(book));
+}
+
+GuessResult GuessResult::Unpack(PackedFeedback packed) {
+    GuessResult result;
+    unsigned rest = packed;
+    result.book = static_cast<Feedback>(rest % 3);
+    for (Feedback& digit : result.digits) {
+        rest /= 3;
+        digit = static_cast<Feedback>(rest % 3);
+    }
+    return result;
+}
+
+namespace {
+
+char feedbackLetter(Feedback feedback) {
+    switch (feedback) {
+    case Feedback::Green: return 'g';
+    case Feedback::Yellow: return 'y';
+    case Feedback::Gray: break;
+    }
+    return 'x';
+}
+
+bool parseFeedbackLetter(char letter, Feedback& feedback) {
+    switch (letter) {
+    case 'g': case 'G': feedback = Feedback::Green; return true;
+    case 'y': case 'Y': feedback = Feedback::Yellow; return true;
+    case 'x': case 'X': feedback = Feedback::Gray; return true;
+    }
+    return false;
+}
+
+}
+
+std::string GuessResult::text() const {
+    std::string letters(1, feedbackLetter(book));
+    for (const Feedback digit : digits) letters.push_back(feedbackLetter(digit));
+    return letters;
+}
+
+bool GuessResult::Parse(std::string_view text, GuessResult& result) {
+    if (text.size() != 1 + result.digits.size()) return false;
+    GuessResult parsed;
+    if (!parseFeedbackLetter(text[0], parsed.book)) return false;
+    for (std::size_t i = 0; i < parsed.digits.size(); ++i) {
+        if (!parseFeedbackLetter(text[i + 1], parsed.digits[i])) return false;
+    }
+    result = parsed;
+    return true;
+}
+
+std::array<uint8_t, 4> AnswerDigits(int chapter, int verse) {
+    auto firstTwo = [](int value) {
+        while (value >= 100) value /= 10;
+        return std::array<uint8_t, 2>{static_cast<uint8_t>(value / 10), static_cast<uint8_t>(value % 10)};
+    };
+    const auto c = firstTwo(chapter);
+    const auto v = firstTwo(verse);
+    return {c[0], c[1], v[0], v[1]};
+}
+
+ScoreCode EncodeAnswer(const VerseStore& store, std::size_t index) {
+    ScoreCode code;
+    code.book = store.bookId(index);
+    code.area = store.areaId(index);
+    code.digits = AnswerDigits(store.chapter(index), store.verse(index));
+    return code;
+}
+
+ScoreCode EncodeGuess(const VerseStore& store, std::string_view book, std::string_view digits) {
+    ScoreCode code;
+    code.book = store.findBook(book);
+    // A green book needs the exact name, but the area, as in getBookArea,
+    // ignores case.
+    uint8_t areaBook = code.book;
+    if (areaBook == kNoLabel) {
+        std::string lower(book);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        areaBook = store.findBook(lower);
+    }
+    code.area = areaBook != kNoLabel ? store.guessArea(areaBook) : kNoLabel;
+    for (std::size_t i = 0; i < code.digits.size() && i < digits.size(); ++i) {
+        if (digits[i] >= '0' && digits[i] <= '9') code.digits[i] = static_cast<uint8_t>(digits[i] - '0');
+    }
+    return code;
+}
+
+ScoreCode EncodeVerseGuess(const VerseStore& store, std::size_t index) {
+    ScoreCode code;
+    code.book = store.bookId(index);
+    code.area = store.guessArea(code.book);
+    code.digits = AnswerDigits(store.chapter(index), store.verse(index));
+    return code;
+}
+
+PackedFeedback Score(const ScoreCode& guess, const ScoreCode& answer) {
+    unsigned book = 0;
+    if (guess.book == answer.book) {
+        book = 2;
+    } else if (guess.area == answer.area) {
+        book = 1;
+    }
+
+    bool used[4];
+    for (int i = 0; i < 4; ++i) used[i] = guess.digits[i] == answer.digits[i];
+
+    unsigned packed = 0;
+    unsigned weight = 3;
+    for (int i = 0; i < 4; ++i, weight *= 3) {
+        if (guess.digits[i] == answer.digits[i]) {
+            packed += 2 * weight;
+            continue;
+        }
+        for (int j = 0; j < 4; ++j) {
+            if (!used[j] && guess.digits[i] == answer.digits[j]) {
+                used[j] = true;
+                packed += weight;
+                break;
+            }
+        }
+    }
+    return static_cast<PackedFeedback>(packed + book);
+}
+
+void ScoreTable::clear() {
+    m_book.clear();
+    m_area.clear();
+    for (auto& column : m_digits) column.clear();
+}
+
+void ScoreTable::reserve(std::size_t count) {
+    m_book.reserve(count);
+    m_area.reserve(count);
+    for (auto& column : m_digits) column.reserve(count);
+}
+
+void ScoreTable::push_back(const ScoreCode& code) {
+    m_book.push_back(code.book);
+    m_area.push_back(code.area);
+    for (int i = 0; i < 4; ++i) m_digits[i].push_back(code.digits[i]);
+}
+
+void ScoreTable::assignAnswers(const VerseStore& store) {
+    clear();
+    reserve(store.size());
+    for (std::size_t i = 0; i < store.size(); ++i) push_back(EncodeAnswer(store, i));
+}
+
+void ScoreTable::assignGuesses(const VerseStore& store) {
+    clear();
+    reserve(store.size());
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        ScoreCode code;
+        code.book = store.bookId(i);
+        code.area = store.guessArea(code.book);
+        code.digits = AnswerDigits(store.chapter(i), store.verse(i));
+        push_back(code);
+    }
+}
+
+ScoreCode ScoreTable::code(std::size_t index) const {
+    ScoreCode code;
+    code.book = m_book[index];
+    code.area = m_area[index];
+    for (int i = 0; i < 4; ++i) code.digits[i] = m_digits[i][index];
+    return code;
+}
+
+namespace {
+
+#if defined(BIBIRBLE_SCORING_SSE2)
+
+// Sixteen codes per side, one per byte lane. Either side may be a broadcast.
+struct CodeLanes {
+    __m128i book;
+    __m128i area;
+    __m128i digits[4];
+};
+
+CodeLanes broadcastLanes(const ScoreCode& code) {
+    CodeLanes lanes;
+    lanes.book = _mm_set1_epi8(static_cast<char>(code.book));
+    lanes.area = _mm_set1_epi8(static_cast<char>(code.area));
+    for (int i = 0; i < 4; ++i) lanes.digits[i] = _mm_set1_epi8(static_cast<char>(code.digits[i]));
+    return lanes;
+}
+
+CodeLanes loadLanes(const ScoreTable& table, std::size_t index) {
+    auto load = [index](const uint8_t* column) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + index));
+    };
+    CodeLanes lanes;
+    lanes.book = load(table.books());
+    lanes.area = load(table.areas());
+    for (int i = 0; i < 4; ++i) lanes.digits[i] = load(table.digits(i));
+    return lanes;
+}
+
+// Lane-wise copy of Score(): the same green pass and the same left-to-right
+// yellow search, with the branches turned into masks.
+__m128i scoreLanes(const CodeLanes& guess, const CodeLanes& answer) {
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi8(2);
+
+    const __m128i bookGreen = _mm_cmpeq_epi8(guess.book, answer.book);
+    const __m128i bookYellow = _mm_andnot_si128(bookGreen, _mm_cmpeq_epi8(guess.area, answer.area));
+    const __m128i book = _mm_or_si128(_mm_and_si128(bookGreen, two), _mm_and_si128(bookYellow, one));
+
+    __m128i green[4], used[4], value[4];
+    for (int i = 0; i < 4; ++i) {
+        green[i] = _mm_cmpeq_epi8(guess.digits[i], answer.digits[i]);
+        used[i] = green[i];
+    }
+    for (int i = 0; i < 4; ++i) {
+        __m128i settled = green[i];
+        __m128i yellow = _mm_setzero_si128();
+        for (int j = 0; j < 4; ++j) {
+            const __m128i hit = _mm_andnot_si128(_mm_or_si128(settled, used[j]),
+                                                 _mm_cmpeq_epi8(guess.digits[i], answer.digits[j]));
+            yellow = _mm_or_si128(yellow, hit);
+            used[j] = _mm_or_si128(used[j], hit);
+            settled = _mm_or_si128(settled, hit);
+        }
+        value[i] = _mm_or_si128(_mm_and_si128(green[i], two), _mm_and_si128(yellow, one));
+    }
+
+    // Horner's rule in base 3; every intermediate fits in a byte.
+    __m128i packed = value[3];
+    for (int i = 2; i >= 0; --i) {
+        packed = _mm_add_epi8(value[i], _mm_add_epi8(packed, _mm_add_epi8(packed, packed)));
+    }
+    return _mm_add_epi8(book, _mm_add_epi8(packed, _mm_add_epi8(packed, packed)));
+}
+
+void storeLanes(PackedFeedback* out, __m128i packed) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+}
+
+#endif
+
+}
+
+void ScoreAgainstAnswers(const ScoreCode& guess, const ScoreTable& answers, PackedFeedback* out) {
+    const std::size_t count = answers.size();
+    std::size_t i = 0;
+#if defined(BIBIRBLE_SCORING_SSE2)
+    const CodeLanes guessLanes = broadcastLanes(guess);
+    for (; i + 16 <= count; i += 16) {
+        storeLanes(out + i, scoreLanes(guessLanes, loadLanes(answers, i)));
+    }
+#endif
+    for (; i < count; ++i) out[i] = Score(guess, answers.code(i));
+}
+
+void ScoreAgainstGuesses(const ScoreTable& guesses, const ScoreCode& answer, PackedFeedback* out) {
+    const std::size_t count = guesses.size();
+    std::size_t i = 0;
+#if defined(BIBIRBLE_SCORING_SSE2)
+    const CodeLanes answerLanes = broadcastLanes(answer);
+    for (; i + 16 <= count; i += 16) {
+        storeLanes(out + i, scoreLanes(loadLanes(guesses, i), answerLanes));
+    }
+#endif
+    for (; i < count; ++i) out[i] = Score(guesses.code(i), answer);
+}
+
+const char* ScoringKernel() {
+#if defined(BIBIRBLE_SCORING_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
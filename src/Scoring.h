@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "VerseStore.h"
+
+// Colour shown for one part of a guess.
+enum class Feedback : uint8_t {
+    Gray,
+    Yellow,
+    Green
+};
+
+// Feedback for a whole guess packed into one byte as base-3 digits:
+// book + 3 * (d0 + 3 * d1 + 9 * d2 + 27 * d3), where d0..d3 are the two
+// chapter digits and the two verse digits. Values run from 0 to 242.
+using PackedFeedback = uint8_t;
+constexpr int kFeedbackPatterns = 243;
+constexpr PackedFeedback kSolvedFeedback = kFeedbackPatterns - 1;
+
+// Feedback for the book and the four chapter:verse digits of one guess.
+struct GuessResult {
+    Feedback book = Feedback::Gray;
+    std::array<Feedback, 4> digits = {};
+
+    bool correct() const;
+    PackedFeedback pack() const;
+    static GuessResult Unpack(PackedFeedback packed);
+    // Five letters, book first: 'g' green, 'y' yellow, 'x' gray.
+    std::string text() const;
+    static bool Parse(std::string_view text, GuessResult& result);
+};
+
+// Marks a guess character that is not a digit; it never matches.
+constexpr uint8_t kNoDigit = 0xFF;
+
+// A guess or an answer reduced to small integers. Books and areas are ids in
+// a VerseStore's tables (kNoLabel when the name is not in the store) and
+// digits are 0-9 (kNoDigit for a non-digit guess character).
+struct ScoreCode {
+    uint8_t book = kNoLabel;
+    uint8_t area = kNoLabel;
+    std::array<uint8_t, 4> digits = {kNoDigit, kNoDigit, kNoDigit, kNoDigit};
+};
+
+// The digits a player enters for chapter:verse, as printed by "%02d" into
+// two-character boxes: a three-digit chapter keeps its first two digits.
+std::array<uint8_t, 4> AnswerDigits(int chapter, int verse);
+
+// Code for verse `index` of `store` as the answer.
+ScoreCode EncodeAnswer(const VerseStore& store, std::size_t index);
+// Code for a typed guess. The area is the book's canonical area
+// (VerseStore::guessArea), which is what decides a yellow book. The book
+// must match exactly; the area is looked up without regard to case.
+ScoreCode EncodeGuess(const VerseStore& store, std::string_view book, std::string_view digits);
+// Code for guessing the reference of verse `index` of `store`.
+ScoreCode EncodeVerseGuess(const VerseStore& store, std::size_t index);
+
+// Scores a guess with the two-pass rule: exact digit matches turn green
+// first, then each remaining guess digit, left to right, turns yellow if it
+// matches a still-unused answer digit. The book is green on an exact match
+// and yellow when its area matches the answer's.
+PackedFeedback Score(const ScoreCode& guess, const ScoreCode& answer);
+
+// Codes stored column by column for the batch scorers.
+class ScoreTable {
+public:
+    void clear();
+    void reserve(std::size_t count);
+    void push_back(const ScoreCode& code);
+    // Every verse of `store` encoded as an answer, or as a guess.
+    void assignAnswers(const VerseStore& store);
+    void assignGuesses(const VerseStore& store);
+
+    std::size_t size() const { return m_book.size(); }
+    bool empty() const { return m_book.empty(); }
+    ScoreCode code(std::size_t index) const;
+
+    const uint8_t* books() const { return m_book.data(); }
+    const uint8_t* areas() const { return m_area.data(); }
+    const uint8_t* digits(int position) const { return m_digits[position].data(); }
+
+private:
+    std::vector<uint8_t> m_book;
+    std::vector<uint8_t> m_area;
+    std::array<std::vector<uint8_t>, 4> m_digits;
+};
+
+// Writes Score(guess, answers.code(i)) to out[i] for every answer.
+void ScoreAgainstAnswers(const ScoreCode& guess, const ScoreTable& answers, PackedFeedback* out);
+// Writes Score(guesses.code(i), answer) to out[i] for every guess.
+void ScoreAgainstGuesses(const ScoreTable& guesses, const ScoreCode& answer, PackedFeedback* out);
+
+// Name of the batch kernel compiled for this target: "sse2" or "scalar".
+const char* ScoringKernel();
@@ -0,0 +1,327 @@
+#include "Simulator.h"
+#include "Solver.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <future>
+
+namespace {
+
+// Games per unit of work handed to a worker.
+constexpr uint64_t kChunkGames = 256;
+
+uint64_t splitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint8_t randomDigit(std::mt19937_64& rng) {
+    return static_cast<uint8_t>(rng() % 10);
+}
+
+// Area each book is scored with when guessed, indexed by book id.
+std::vector<uint8_t> guessAreas(const VerseStore& store) {
+    std::vector<uint8_t> areas;
+    for (const std::string& book : store.bookNames()) {
+        areas.push_back(EncodeGuess(store, book, "0000").area);
+    }
+    return areas;
+}
+
+ScoreCode guessCode(const std::vector<uint8_t>& areas, uint8_t book, const std::array<uint8_t, 4>& digits) {
+    ScoreCode code;
+    code.book = book;
+    code.area = areas[book];
+    code.digits = digits;
+    return code;
+}
+
+class RandomStrategy : public Strategy {
+public:
+    explicit RandomStrategy(std::shared_ptr<const std::vector<uint8_t>> areas) : m_areas(std::move(areas)) {}
+
+    ScoreCode nextGuess(const SimulatedGame&, std::mt19937_64& rng) override {
+        const uint8_t book = static_cast<uint8_t>(rng() % m_areas->size());
+        return guessCode(*m_areas, book, {randomDigit(rng), randomDigit(rng), randomDigit(rng), randomDigit(rng)});
+    }
+
+private:
+    std::shared_ptr<const std::vector<uint8_t>> m_areas;
+};
+
+class AreaStrategy : public Strategy {
+public:
+    AreaStrategy(std::shared_ptr<const std::vector<uint8_t>> areas, std::vector<uint8_t> bookAreas)
+        : m_areas(std::move(areas)), m_bookAreas(std::move(bookAreas)) {}
+
+    void newGame() override {
+        m_allowed.assign(m_bookAreas.size(), 1);
+        m_pinned.fill(kNoDigit);
+        m_excluded.fill(0);
+    }
+
+    ScoreCode nextGuess(const SimulatedGame& game, std::mt19937_64& rng) override {
+        if (!game.results.empty()) learn(game.guesses.back(), game.results.back());
+
+        std::vector<uint8_t> books;
+        for (std::size_t b = 0; b < m_allowed.size(); ++b) {
+            if (m_allowed[b]) books.push_back(static_cast<uint8_t>(b));
+        }
+        const uint8_t book = books.empty() ? static_cast<uint8_t>(rng() % m_allowed.size())
+                                           : books[rng() % books.size()];
+
+        std::array<uint8_t, 4> digits;
+        for (int p = 0; p < 4; ++p) {
+            if (m_pinned[p] != kNoDigit) {
+                digits[p] = m_pinned[p];
+                continue;
+            }
+            uint8_t digit = randomDigit(rng);
+            if (m_excluded[p] != 0x3FF) {
+                while (m_excluded[p] & (1u << digit)) digit = randomDigit(rng);
+            }
+            digits[p] = digit;
+        }
+        return guessCode(*m_areas, book, digits);
+    }
+
+private:
+    void learn(const ScoreCode& guess, const GuessResult& result) {
+        for (std::size_t b = 0; b < m_allowed.size(); ++b) {
+            const bool sameArea = guess.area != kNoLabel && m_bookAreas[b] == guess.area;
+            switch (result.book) {
+            case Feedback::Green: m_allowed[b] = b == guess.book; break;
+            case Feedback::Yellow: m_allowed[b] &= sameArea && b != guess.book; break;
+            case Feedback::Gray: m_allowed[b] &= !sameArea && b != guess.book; break;
+            }
+        }
+        for (int p = 0; p < 4; ++p) {
+            const uint8_t digit = guess.digits[p];
+            if (digit > 9) continue;
+            if (result.digits[p] == Feedback::Green) m_pinned[p] = digit;
+            else m_excluded[p] |= static_cast<uint16_t>(1u << digit);
+        }
+    }
+
+    std::shared_ptr<const std::vector<uint8_t>> m_areas;
+    // Area of each book's verses, i.e. what its answers are scored with.
+    std::vector<uint8_t> m_bookAreas;
+    std::vector<uint8_t> m_allowed;
+    std::array<uint8_t, 4> m_pinned;
+    std::array<uint16_t, 4> m_excluded;
+};
+
+class CandidateStrategy : public Strategy {
+public:
+    explicit CandidateStrategy(std::shared_ptr<const ScoreTable> guesses) : m_guesses(std::move(guesses)) {}
+
+    bool usesCandidates() const override { return true; }
+
+    ScoreCode nextGuess(const SimulatedGame& game, std::mt19937_64& rng) override {
+        const VerseBitset& candidates = game.candidates;
+        std::size_t pick = rng() % candidates.count();
+        const uint64_t* words = candidates.words();
+        for (std::size_t w = 0; w < candidates.wordCount(); ++w) {
+            const std::size_t bits = std::bitset<64>(words[w]).count();
+            if (pick >= bits) {
+                pick -= bits;
+                continue;
+            }
+            uint64_t word = words[w];
+            for (; pick > 0; --pick) word &= word - 1;
+            return m_guesses->code(w * 64 + VerseBitset::CountTrailingZeros(word));
+        }
+        return ScoreCode();
+    }
+
+private:
+    std::shared_ptr<const ScoreTable> m_guesses;
+};
+
+class SolverStrategy : public Strategy {
+public:
+    SolverStrategy(const VerseStore& store, std::shared_ptr<const std::vector<uint8_t>> areas, const Hint& opening)
+        : m_solver(store, 1), m_areas(std::move(areas)), m_opening(opening) {}
+
+    bool usesCandidates() const override { return true; }
+
+    ScoreCode nextGuess(const SimulatedGame& game, std::mt19937_64&) override {
+        const Hint hint = game.guesses.empty() ? m_opening : m_solver.bestGuess(game.candidates);
+        return guessCode(*m_areas, hint.book, hint.digits);
+    }
+
+private:
+    Solver m_solver;
+    std::shared_ptr<const std::vector<uint8_t>> m_areas;
+    Hint m_opening;
+};
+
+}
+
+const std::vector<std::string>& StrategyNames() {
+    static const std::vector<std::string> names = {"random", "area", "candidate", "solver"};
+    return names;
+}
+
+StrategyFactory MakeStrategyFactory(const std::string& name, const BibleData& data) {
+    const VerseStore& store = data.store();
+    if (store.empty()) return StrategyFactory();
+    auto areas = std::make_shared<const std::vector<uint8_t>>(guessAreas(store));
+
+    if (name == "random") {
+        return [areas]() { return std::unique_ptr<Strategy>(new RandomStrategy(areas)); };
+    }
+    if (name == "area") {
+        std::vector<uint8_t> bookAreas(store.bookNames().size(), kNoLabel);
+        for (std::size_t i = 0; i < store.size(); ++i) bookAreas[store.bookId(i)] = store.areaId(i);
+        return [areas, bookAreas]() { return std::unique_ptr<Strategy>(new AreaStrategy(areas, bookAreas)); };
+    }
+    if (name == "candidate") {
+        auto guesses = std::make_shared<ScoreTable>();
+        guesses->assignGuesses(store);
+        std::shared_ptr<const ScoreTable> table = guesses;
+        return [table]() { return std::unique_ptr<Strategy>(new CandidateStrategy(table)); };
+    }
+    if (name == "solver") {
+        Solver solver(store);
+        if (!data.sourcePath().empty()) solver.loadFirstGuess(FirstGuessCachePath(data.sourcePath()));
+        const Hint opening = solver.firstGuess();
+        if (!opening.valid()) return StrategyFactory();
+        return [&store, areas, opening]() {
+            return std::unique_ptr<Strategy>(new SolverStrategy(store, areas, opening));
+        };
+    }
+    return StrategyFactory();
+}
+
+double SimulationReport::meanGuesses() const {
+    if (games == 0) return 0.0;
+    uint64_t total = guessHistogram[0] * GameEngine::kMaxGuesses;
+    for (std::size_t k = 1; k < guessHistogram.size(); ++k) total += k * guessHistogram[k];
+    return static_cast<double>(total) / games;
+}
+
+// Per-worker totals, aligned so neighbouring workers' histograms never share
+// a cache line.
+struct alignas(64) Simulator::Shard {
+    std::array<uint64_t, GameEngine::kMaxGuesses + 1> guessHistogram = {};
+    std::vector<VerseStats> verses;
+    std::vector<BookStats> books;
+};
+
+Simulator::Simulator(const BibleData& data)
+    : m_data(data) {
+    m_index.build(data.store());
+    m_answers.assignAnswers(data.store());
+}
+
+void Simulator::playChunk(Strategy& strategy, uint64_t chunk, uint64_t games, uint64_t seed, Difficulty tier,
+                          SimulatedGame& game, Shard& shard) const {
+    TRACE_SCOPE("Simulator::playChunk");
+    const VerseStore& store = m_data.store();
+    const bool tracking = strategy.usesCandidates();
+    std::mt19937_64 rng(splitMix64(seed ^ splitMix64(chunk)));
+
+    for (uint64_t g = 0; g < games; ++g) {
+        const std::size_t target = m_data.sampleVerse(tier, rng);
+        const ScoreCode answer = m_answers.code(target);
+        BookStats& book = shard.books[store.bookId(target)];
+
+        strategy.newGame();
+        game.guesses.clear();
+        game.results.clear();
+        if (tracking) game.candidates.assign(store.size(), true);
+
+        int won = 0;
+        for (int turn = 0; turn < GameEngine::kMaxGuesses; ++turn) {
+            const ScoreCode guess = strategy.nextGuess(game, rng);
+            const PackedFeedback feedback = Score(guess, answer);
+            ++book.feedback[feedback];
+            game.guesses.push_back(guess);
+            game.results.push_back(GuessResult::Unpack(feedback));
+            if (feedback == kSolvedFeedback) {
+                won = turn + 1;
+                break;
+            }
+            if (tracking) m_index.narrow(game.candidates, guess, feedback);
+        }
+
+        const int used = won ? won : GameEngine::kMaxGuesses;
+        ++shard.guessHistogram[won];
+        VerseStats& verse = shard.verses[target];
+        ++verse.plays;
+        verse.wins += won ? 1 : 0;
+        verse.guesses += used;
+        ++book.plays;
+        book.wins += won ? 1 : 0;
+        book.guesses += used;
+    }
+}
+
+SimulationReport Simulator::run(const std::string& strategyName, const StrategyFactory& factory,
+                                uint64_t games, uint64_t seed, Difficulty tier, std::size_t threads) const {
+    const auto startedAt = std::chrono::steady_clock::now();
+    const std::size_t verseCount = m_data.verseCount();
+    const std::size_t bookCount = m_data.store().bookNames().size();
+    const uint64_t chunks = (games + kChunkGames - 1) / kChunkGames;
+
+    SimulationReport report;
+    report.strategy = strategyName;
+    report.games = games;
+    report.seed = seed;
+    report.difficulty = tier;
+    report.verses.assign(verseCount, VerseStats());
+    report.books.assign(bookCount, BookStats());
+    if (verseCount == 0 || !factory) {
+        report.games = 0;
+        return report;
+    }
+    report.threads = static_cast<std::size_t>(std::max<uint64_t>(1, std::min<uint64_t>(threads, chunks)));
+
+    std::vector<Shard> shards(report.threads);
+    std::atomic<uint64_t> nextChunk(0);
+    {
+        ThreadPool pool(report.threads);
+        std::vector<std::future<void>> workers;
+        for (Shard& shard : shards) {
+            workers.push_back(pool.submit([&, this]() {
+                shard.verses.assign(verseCount, VerseStats());
+                shard.books.assign(bookCount, BookStats());
+                const std::unique_ptr<Strategy> strategy = factory();
+                SimulatedGame game;
+                for (;;) {
+                    const uint64_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= chunks) break;
+                    const uint64_t count = std::min(kChunkGames, games - chunk * kChunkGames);
+                    playChunk(*strategy, chunk, count, seed, tier, game, shard);
+                }
+            }));
+        }
+        for (auto& worker : workers) worker.get();
+    }
+
+    for (const Shard& shard : shards) {
+        for (std::size_t k = 0; k < shard.guessHistogram.size(); ++k) {
+            report.guessHistogram[k] += shard.guessHistogram[k];
+        }
+        for (std::size_t i = 0; i < verseCount; ++i) {
+            report.verses[i].plays += shard.verses[i].plays;
+            report.verses[i].wins += shard.verses[i].wins;
+            report.verses[i].guesses += shard.verses[i].guesses;
+        }
+        for (std::size_t b = 0; b < bookCount; ++b) {
+            BookStats& total = report.books[b];
+            const BookStats& part = shard.books[b];
+            total.plays += part.plays;
+            total.wins += part.wins;
+            total.guesses += part.guesses;
+            for (int f = 0; f < kFeedbackPatterns; ++f) total.feedback[f] += part.feedback[f];
+        }
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    return report;
+}
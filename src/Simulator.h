@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "BibleData.h"
+#include "CandidateIndex.h"
+#include "GameEngine.h"
+#include "Scoring.h"
+#include "ThreadPool.h"
+
+// One simulated game as a strategy sees it: the guesses so far and their
+// feedback, plus the verses still consistent with them when the strategy
+// asked for candidate tracking.
+struct SimulatedGame {
+    std::vector<ScoreCode> guesses;
+    std::vector<GuessResult> results;
+    VerseBitset candidates;
+};
+
+// A way of playing. The simulator creates one instance per worker thread, so
+// implementations may keep per-game state without locking.
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+
+    // Called before the first guess of every game.
+    virtual void newGame() {}
+    // Whether SimulatedGame::candidates should be maintained; it costs one
+    // CandidateIndex::narrow per guess.
+    virtual bool usesCandidates() const { return false; }
+    virtual ScoreCode nextGuess(const SimulatedGame& game, std::mt19937_64& rng) = 0;
+};
+
+using StrategyFactory = std::function<std::unique_ptr<Strategy>()>;
+
+// Strategies by name:
+//   random     any book and any four digits, ignoring feedback
+//   area       narrows books by the book colour (a yellow keeps the area)
+//              and keeps green digits
+//   candidate  a uniformly random verse still consistent with all feedback
+//   solver     Solver's highest-entropy guess
+// Returns an empty factory for an unknown name. The opening hint of "solver"
+// is computed (or read from its cache) once here and shared by all workers.
+StrategyFactory MakeStrategyFactory(const std::string& name, const BibleData& data);
+const std::vector<std::string>& StrategyNames();
+
+struct VerseStats {
+    uint32_t plays = 0;
+    uint32_t wins = 0;
+    // Guesses used, with a lost game counting kMaxGuesses.
+    uint64_t guesses = 0;
+};
+
+struct BookStats {
+    uint64_t plays = 0;
+    uint64_t wins = 0;
+    uint64_t guesses = 0;
+    // How often each packed feedback was shown in games on this book.
+    std::array<uint64_t, kFeedbackPatterns> feedback = {};
+};
+
+// Totals of a simulation run. Verses and books are indexed like the store;
+// book statistics are grouped by the answer's book.
+struct SimulationReport {
+    std::string strategy;
+    uint64_t games = 0;
+    uint64_t seed = 0;
+    Difficulty difficulty = Difficulty::Normal;
+    std::size_t threads = 0;
+    double seconds = 0.0;
+    // [0] counts lost games, [k] games won with the k-th guess.
+    std::array<uint64_t, GameEngine::kMaxGuesses + 1> guessHistogram = {};
+    std::vector<VerseStats> verses;
+    std::vector<BookStats> books;
+
+    uint64_t wins() const { return games - guessHistogram[0]; }
+    double meanGuesses() const;
+};
+
+// Plays games on verses drawn for a difficulty tier with one strategy on a pool of
+// workers. Games are dealt out in fixed-size chunks from a shared counter,
+// so a worker that finishes early just claims the next chunk. Every chunk
+// seeds its own generator from (seed, chunk number), which makes a report
+// depend only on the seed and game count, not on the thread count or on
+// which worker ran what. Workers accumulate into private statistics that are
+// summed once at the end, so the hot loop shares no writable memory.
+class Simulator {
+public:
+    explicit Simulator(const BibleData& data);
+
+    SimulationReport run(const std::string& strategyName, const StrategyFactory& factory,
+                         uint64_t games, uint64_t seed, Difficulty tier = Difficulty::Normal,
+                         std::size_t threads = ThreadPool::DefaultThreadCount()) const;
+
+private:
+    struct Shard;
+
+    void playChunk(Strategy& strategy, uint64_t chunk, uint64_t games, uint64_t seed, Difficulty tier,
+                   SimulatedGame& game, Shard& shard) const;
+
+    const BibleData& m_data;
+    CandidateIndex m_index;
+    ScoreTable m_answers;
+};
@@ -0,0 +1,392 @@
+#include "Solver.h"
+#include "BibleData.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string_view>
+#include <unordered_set>
+
+namespace {
+
+constexpr int kDigitPatterns = 81;
+constexpr int kDigitGuesses = 10000;
+constexpr uint16_t kAllDigitsGreen = kDigitPatterns - 1;
+// Candidate sets this small also try every candidate as the guess, so a
+// guess that can win is preferred over an equally informative one that cannot.
+constexpr std::size_t kCandidateGuessLimit = 256;
+// Digit guesses are deduplicated by feedback vector up to this many distinct
+// answer digit strings (10^4 vectors of this many bytes).
+constexpr std::size_t kDedupeTupleLimit = 256;
+// Bump when the choice rules change so stale first-guess caches are ignored.
+constexpr uint64_t kSolverVersion = 1;
+constexpr char kCacheTag[] = "bibirble-first-guess";
+const double kLog2Of3 = std::log2(3.0);
+
+uint64_t fnv1a(uint64_t hash, const void* data, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint16_t digitCode(const std::array<uint8_t, 4>& digits) {
+    return static_cast<uint16_t>(digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3]);
+}
+
+std::array<uint8_t, 4> codeDigits(uint16_t code) {
+    return {static_cast<uint8_t>(code / 1000), static_cast<uint8_t>(code / 100 % 10),
+            static_cast<uint8_t>(code / 10 % 10), static_cast<uint8_t>(code % 10)};
+}
+
+}
+
+std::string Hint::digitString() const {
+    std::string text;
+    for (const uint8_t digit : digits) text.push_back(static_cast<char>('0' + digit));
+    return text;
+}
+
+Solver::Solver(const VerseStore& store, std::size_t threadCount)
+    : m_store(store),
+      m_pool(new ThreadPool(threadCount)) {
+    const std::size_t n = store.size();
+    const std::size_t bookCount = store.bookNames().size();
+
+    m_bookGroups.assign(bookCount, {});
+    m_verseGroup.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint8_t book = store.bookId(i);
+        const uint8_t area = store.areaId(i);
+        std::size_t group = 0;
+        while (group < m_groupBook.size() && (m_groupBook[group] != book || m_groupArea[group] != area)) ++group;
+        if (group == m_groupBook.size()) {
+            m_groupBook.push_back(book);
+            m_groupArea.push_back(area);
+            m_bookGroups[book].push_back(static_cast<uint16_t>(group));
+        }
+        m_verseGroup[i] = static_cast<uint16_t>(group);
+    }
+    for (std::size_t b = 0; b < store.bookNames().size(); ++b) {
+        m_guessArea.push_back(store.guessArea(static_cast<uint8_t>(b)));
+    }
+
+    m_nlogn.resize(n + 1);
+    for (std::size_t count = 1; count <= n; ++count) {
+        m_nlogn[count] = count * std::log2(static_cast<double>(count));
+    }
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = fnv1a(hash, &kSolverVersion, sizeof(kSolverVersion));
+    for (const auto* names : {&store.bookNames(), &store.areaNames()}) {
+        for (const auto& name : *names) hash = fnv1a(hash, name.c_str(), name.size() + 1);
+    }
+    hash = fnv1a(hash, m_guessArea.data(), m_guessArea.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint16_t row[4] = {store.bookId(i), store.areaId(i), store.chapter(i), store.verse(i)};
+        hash = fnv1a(hash, row, sizeof(row));
+    }
+    m_fingerprint = hash;
+}
+
+ScoreCode Solver::DigitGuessCode(uint16_t digits) {
+    // No book or area: the book colour is always gray and the packed
+    // feedback is three times the digit pattern.
+    ScoreCode code;
+    code.digits = codeDigits(digits);
+    return code;
+}
+
+bool Solver::Better(const Hint& a, const Hint& b) {
+    if (!b.valid()) return a.valid();
+    if (!a.valid()) return false;
+    if (std::fabs(a.entropy - b.entropy) > 1e-9) return a.entropy > b.entropy;
+    if (a.couldWin != b.couldWin) return a.couldWin;
+    const uint16_t aDigits = digitCode(a.digits);
+    const uint16_t bDigits = digitCode(b.digits);
+    if (aDigits != bDigits) return aDigits < bDigits;
+    return a.book < b.book;
+}
+
+double Solver::entropy(const uint32_t* counts, std::size_t buckets, std::size_t total) const {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < buckets; ++i) sum += m_nlogn[counts[i]];
+    return std::log2(static_cast<double>(total)) - sum / static_cast<double>(total);
+}
+
+Solver::Buckets Solver::collapse(const VerseBitset& candidates) const {
+    std::vector<uint32_t> keys;
+    keys.reserve(candidates.count());
+    candidates.forEach([&](std::size_t i) {
+        const uint16_t digits = digitCode(AnswerDigits(m_store.chapter(i), m_store.verse(i)));
+        keys.push_back(static_cast<uint32_t>(digits) << 16 | m_verseGroup[i]);
+    });
+    std::sort(keys.begin(), keys.end());
+
+    Buckets buckets;
+    buckets.total = keys.size();
+    uint32_t lastTuple = ~0u;
+    for (std::size_t k = 0; k < keys.size();) {
+        const uint32_t key = keys[k];
+        std::size_t end = k;
+        while (end < keys.size() && keys[end] == key) ++end;
+
+        const uint32_t tuple = key >> 16;
+        if (tuple != lastTuple) {
+            ScoreCode code;
+            code.book = 0;
+            code.area = 0;
+            code.digits = codeDigits(static_cast<uint16_t>(tuple));
+            buckets.tuples.push_back(code);
+            buckets.tupleCounts.push_back(0);
+            lastTuple = tuple;
+        }
+        const uint32_t count = static_cast<uint32_t>(end - k);
+        buckets.tupleCounts.back() += count;
+        buckets.pairTuple.push_back(static_cast<uint32_t>(buckets.tuples.size() - 1));
+        buckets.pairGroup.push_back(static_cast<uint16_t>(key & 0xFFFF));
+        buckets.pairCounts.push_back(count);
+        k = end;
+    }
+    return buckets;
+}
+
+Hint Solver::expand(const Buckets& buckets, uint16_t digits) const {
+    std::vector<PackedFeedback> feedback(buckets.tuples.size());
+    ScoreAgainstAnswers(DigitGuessCode(digits), buckets.tuples, feedback.data());
+
+    // Histograms only cover the digit patterns that occur; late in a game
+    // that is a handful of the 81.
+    uint8_t slot[kDigitPatterns];
+    std::fill(std::begin(slot), std::end(slot), kNoLabel);
+    std::size_t patterns = 0;
+    for (PackedFeedback& packed : feedback) {
+        const unsigned pattern = packed / 3;
+        if (slot[pattern] == kNoLabel) slot[pattern] = static_cast<uint8_t>(patterns++);
+        packed = slot[pattern];
+    }
+
+    const std::size_t areaCount = m_store.areaNames().size();
+    std::vector<uint32_t> groupHist(m_groupBook.size() * patterns, 0);
+    std::vector<uint32_t> areaHist(areaCount * patterns, 0);
+    std::vector<uint32_t> digitHist(patterns, 0);
+    for (std::size_t p = 0; p < buckets.pairCounts.size(); ++p) {
+        const std::size_t pattern = feedback[buckets.pairTuple[p]];
+        const uint16_t group = buckets.pairGroup[p];
+        const uint32_t count = buckets.pairCounts[p];
+        groupHist[group * patterns + pattern] += count;
+        areaHist[m_groupArea[group] * patterns + pattern] += count;
+        digitHist[pattern] += count;
+    }
+
+    // Guessing book b: its own groups are green, other groups of the area
+    // guessArea gives b are yellow, everything else is gray.
+    Hint best;
+    std::vector<uint32_t> split(3 * patterns);
+    for (std::size_t book = 0; book < m_bookGroups.size(); ++book) {
+        const uint8_t guessArea = m_guessArea[book];
+        for (std::size_t pattern = 0; pattern < patterns; ++pattern) {
+            uint32_t green = 0;
+            uint32_t greenInArea = 0;
+            for (const uint16_t group : m_bookGroups[book]) {
+                const uint32_t count = groupHist[group * patterns + pattern];
+                green += count;
+                if (m_groupArea[group] == guessArea) greenInArea += count;
+            }
+            const uint32_t yellow = guessArea < areaCount
+                ? areaHist[guessArea * patterns + pattern] - greenInArea : 0;
+            split[pattern] = green;
+            split[patterns + pattern] = yellow;
+            split[2 * patterns + pattern] = digitHist[pattern] - green - yellow;
+        }
+
+        Hint hint;
+        hint.book = static_cast<uint8_t>(book);
+        hint.digits = codeDigits(digits);
+        hint.entropy = entropy(split.data(), split.size(), buckets.total);
+        hint.candidates = buckets.total;
+        hint.couldWin = slot[kAllDigitsGreen] != kNoLabel && split[slot[kAllDigitsGreen]] > 0;
+        if (Better(hint, best)) best = hint;
+    }
+    return best;
+}
+
+Hint Solver::bestGuess(const VerseBitset& candidates) {
+    TRACE_SCOPE("Solver::bestGuess");
+    const Buckets buckets = collapse(candidates);
+    if (buckets.total == 0) return Hint();
+
+    // Digit-only entropy of every digit guess, in parallel slices. For small
+    // tuple sets the feedback vectors are kept: digit guesses with identical
+    // vectors split the candidates identically, so only the first is expanded.
+    const std::size_t tupleCount = buckets.tuples.size();
+    const bool dedupe = tupleCount <= kDedupeTupleLimit;
+    std::vector<PackedFeedback> vectors(dedupe ? kDigitGuesses * tupleCount : 0);
+    std::vector<DigitGuess> order(kDigitGuesses);
+    const std::size_t slices = m_pool->size() * 4;
+    std::vector<std::future<void>> pending;
+    for (std::size_t slice = 0; slice < slices; ++slice) {
+        const std::size_t begin = kDigitGuesses * slice / slices;
+        const std::size_t end = kDigitGuesses * (slice + 1) / slices;
+        pending.push_back(m_pool->submit([&, begin, end]() {
+            std::vector<PackedFeedback> feedback(buckets.tuples.size());
+            for (std::size_t g = begin; g < end; ++g) {
+                const uint16_t digits = static_cast<uint16_t>(g);
+                ScoreAgainstAnswers(DigitGuessCode(digits), buckets.tuples, feedback.data());
+                if (dedupe) std::copy(feedback.begin(), feedback.end(), vectors.begin() + g * tupleCount);
+                uint32_t hist[kDigitPatterns] = {};
+                for (std::size_t t = 0; t < feedback.size(); ++t) {
+                    hist[feedback[t] / 3] += buckets.tupleCounts[t];
+                }
+                // The book colour splits each digit bucket at most three
+                // ways, and a bucket of one or two verses even less.
+                double bookBits = 0.0;
+                for (const uint32_t count : hist) {
+                    if (count >= 3) bookBits += count * kLog2Of3;
+                    else if (count == 2) bookBits += 2.0;
+                }
+                const double digitEntropy = entropy(hist, kDigitPatterns, buckets.total);
+                order[g] = {digits, digitEntropy, digitEntropy + bookBits / buckets.total};
+            }
+        }));
+    }
+    for (auto& task : pending) task.get();
+    std::stable_sort(order.begin(), order.end(), [](const DigitGuess& a, const DigitGuess& b) {
+        return a.bound > b.bound;
+    });
+
+    // Expand digit guesses in batches. Results are merged in order with the
+    // same stopping rule a sequential scan would use, so the answer does not
+    // depend on the thread count.
+    const double ceiling = std::log2(static_cast<double>(buckets.total));
+    auto bound = [&](std::size_t k) { return std::min(order[k].bound, ceiling); };
+
+    Hint best;
+    std::unordered_set<std::string_view> seen;
+    const std::size_t batch = m_pool->size() * 2;
+    for (std::size_t next = 0; next < order.size();) {
+        std::vector<std::size_t> picked;
+        std::vector<std::future<Hint>> results;
+        while (next < order.size() && picked.size() < batch) {
+            if (best.valid() && bound(next) <= best.entropy + 1e-9) {
+                next = order.size();
+                break;
+            }
+            const uint16_t digits = order[next].digits;
+            if (dedupe) {
+                const char* vector = reinterpret_cast<const char*>(vectors.data() + digits * tupleCount);
+                if (!seen.insert(std::string_view(vector, tupleCount)).second) {
+                    ++next;
+                    continue;
+                }
+            }
+            picked.push_back(next++);
+            results.push_back(m_pool->submit([this, &buckets, digits]() { return expand(buckets, digits); }));
+        }
+
+        bool stop = false;
+        for (std::size_t k = 0; k < results.size(); ++k) {
+            const Hint hint = results[k].get();
+            if (stop || (best.valid() && bound(picked[k]) <= best.entropy + 1e-9)) {
+                stop = true;
+                continue;
+            }
+            if (Better(hint, best)) best = hint;
+        }
+        if (stop) break;
+    }
+
+    if (buckets.total <= kCandidateGuessLimit) {
+        Hint bestCandidate;
+        candidates.forEach([&](std::size_t i) {
+            Hint hint;
+            hint.book = m_store.bookId(i);
+            hint.digits = AnswerDigits(m_store.chapter(i), m_store.verse(i));
+            ScoreCode code;
+            code.book = hint.book;
+            code.area = m_guessArea[hint.book];
+            code.digits = hint.digits;
+            hint.entropy = entropyOf(code, candidates);
+            hint.candidates = buckets.total;
+            hint.couldWin = true;
+            if (Better(hint, bestCandidate)) bestCandidate = hint;
+        });
+        if (bestCandidate.entropy >= best.entropy - 1e-9) best = bestCandidate;
+    }
+    return best;
+}
+
+double Solver::entropyOf(const ScoreCode& guess, const VerseBitset& candidates) const {
+    uint32_t hist[kFeedbackPatterns] = {};
+    std::size_t total = 0;
+    candidates.forEach([&](std::size_t i) {
+        ++hist[Score(guess, EncodeAnswer(m_store, i))];
+        ++total;
+    });
+    return total ? entropy(hist, kFeedbackPatterns, total) : 0.0;
+}
+
+Hint Solver::firstGuess() {
+    std::lock_guard<std::mutex> lock(m_firstGuessMutex);
+    if (!m_haveFirstGuess) {
+        m_firstGuess = bestGuess(VerseBitset(m_store.size(), true));
+        m_haveFirstGuess = true;
+    }
+    return m_firstGuess;
+}
+
+bool Solver::loadFirstGuess(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) return false;
+
+    std::istringstream in(line);
+    std::string tag, fingerprint, book, digits;
+    Hint hint;
+    int couldWin = 0;
+    if (!(in >> tag >> fingerprint >> book >> digits >> hint.entropy >> hint.candidates >> couldWin)) return false;
+    char expected[17];
+    std::snprintf(expected, sizeof(expected), "%016llx", static_cast<unsigned long long>(m_fingerprint));
+    if (tag != kCacheTag || fingerprint != expected || digits.size() != 4) return false;
+
+    hint.book = m_store.findBook(book);
+    if (hint.book == kNoLabel) return false;
+    for (std::size_t i = 0; i < 4; ++i) {
+        if (digits[i] < '0' || digits[i] > '9') return false;
+        hint.digits[i] = static_cast<uint8_t>(digits[i] - '0');
+    }
+    hint.couldWin = couldWin != 0;
+
+    std::lock_guard<std::mutex> lock(m_firstGuessMutex);
+    m_firstGuess = hint;
+    m_haveFirstGuess = true;
+    return true;
+}
+
+bool Solver::saveFirstGuess(const std::string& path) {
+    const Hint hint = firstGuess();
+    if (!hint.valid()) return false;
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    char fingerprint[17];
+    std::snprintf(fingerprint, sizeof(fingerprint), "%016llx", static_cast<unsigned long long>(m_fingerprint));
+    file << kCacheTag << ' ' << fingerprint << ' ' << m_store.bookNames()[hint.book] << ' '
+         << hint.digitString() << ' ' << hint.entropy << ' ' << hint.candidates << ' '
+         << (hint.couldWin ? 1 : 0) << '\n';
+    return static_cast<bool>(file);
+}
+
+std::string FirstGuessCachePath(const std::string& corpusPath) {
+    for (const std::string ext : {".json", ".bin"}) {
+        if (corpusPath.size() >= ext.size() &&
+            corpusPath.compare(corpusPath.size() - ext.size(), ext.size(), ext) == 0) {
+            return corpusPath.substr(0, corpusPath.size() - ext.size()) + ".hint";
+        }
+    }
+    return corpusPath + ".hint";
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "CandidateIndex.h"
+#include "Scoring.h"
+#include "ThreadPool.h"
+#include "VerseStore.h"
+
+// A suggested guess: a book of the store plus four chapter:verse digits.
+struct Hint {
+    uint8_t book = kNoLabel;
+    std::array<uint8_t, 4> digits = {};
+    // Expected information of the guess over the candidates, in bits.
+    double entropy = 0.0;
+    // Candidates the guess was chosen for.
+    std::size_t candidates = 0;
+    // The guess is itself one of the candidates, so it can win outright.
+    bool couldWin = false;
+
+    bool valid() const { return book != kNoLabel; }
+    // The digits as typed into the row, e.g. "0316".
+    std::string digitString() const;
+};
+
+// Picks the guess with the highest expected information (feedback entropy)
+// against a candidate set, over every store book and all 10^4 digit strings.
+//
+// Feedback splits into a digit pattern (81 values) and a book colour. The
+// digit pattern depends only on the answer's digits, so candidates are
+// collapsed to distinct digit strings first and each digit guess gets its
+// digit-only entropy H_d. The book colour adds at most log2(3) bits per digit
+// bucket (less for buckets of one or two verses), so digit guesses are then
+// expanded over all books in descending order of that bound until it can no
+// longer beat the best found. Expanding one digit guess
+// builds 81-bucket histograms per (book, area) group and per area, from which
+// the green/yellow/gray split of every guessed book is read off directly.
+// Both phases are spread over a thread pool.
+class Solver {
+public:
+    explicit Solver(const VerseStore& store, std::size_t threadCount = ThreadPool::DefaultThreadCount());
+    Solver(const Solver&) = delete;
+    Solver& operator=(const Solver&) = delete;
+
+    Hint bestGuess(const VerseBitset& candidates);
+    // bestGuess over the whole store. Computed once, or read from a cache
+    // written by saveFirstGuess for the same corpus.
+    Hint firstGuess();
+    bool loadFirstGuess(const std::string& path);
+    bool saveFirstGuess(const std::string& path);
+    // Hash of everything the solver's answers depend on.
+    uint64_t fingerprint() const { return m_fingerprint; }
+
+    // Entropy of guessing `guess` against `candidates`, by direct scoring.
+    double entropyOf(const ScoreCode& guess, const VerseBitset& candidates) const;
+
+private:
+    struct DigitGuess {
+        uint16_t digits;
+        double entropy;
+        // Upper bound on the entropy of this digit guess with any book.
+        double bound;
+    };
+
+    // Candidates collapsed to distinct answer digit strings, and to
+    // (digit string, group) pairs with their multiplicities.
+    struct Buckets {
+        ScoreTable tuples;
+        std::vector<uint32_t> tupleCounts;
+        std::vector<uint32_t> pairTuple;
+        std::vector<uint16_t> pairGroup;
+        std::vector<uint32_t> pairCounts;
+        std::size_t total = 0;
+    };
+
+    Buckets collapse(const VerseBitset& candidates) const;
+    Hint expand(const Buckets& buckets, uint16_t digits) const;
+    double entropy(const uint32_t* counts, std::size_t buckets, std::size_t total) const;
+    static ScoreCode DigitGuessCode(uint16_t digits);
+    static bool Better(const Hint& a, const Hint& b);
+
+    const VerseStore& m_store;
+    std::unique_ptr<ThreadPool> m_pool;
+    uint64_t m_fingerprint = 0;
+
+    // Distinct (book, area) pairs of the answers and each verse's pair.
+    std::vector<uint8_t> m_groupBook;
+    std::vector<uint8_t> m_groupArea;
+    std::vector<uint16_t> m_verseGroup;
+    std::vector<std::vector<uint16_t>> m_bookGroups;
+    // Area each book is scored with when guessed (VerseStore::guessArea).
+    std::vector<uint8_t> m_guessArea;
+    // n * log2(n) for every possible bucket size.
+    std::vector<double> m_nlogn;
+
+    std::mutex m_firstGuessMutex;
+    bool m_haveFirstGuess = false;
+    Hint m_firstGuess;
+};
+
+// Where the first-guess cache for a corpus lives: `bible_sections.json` or
+// `bible_sections.bin` map to `bible_sections.hint`.
+std::string FirstGuessCachePath(const std::string& corpusPath);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed-size pool of worker threads draining a shared FIFO of tasks.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threadCount = DefaultThreadCount()) {
+        if (threadCount == 0) threadCount = 1;
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static std::size_t DefaultThreadCount() {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        return hardware ? hardware : 1;
+    }
+
+    std::size_t size() const { return m_workers.size(); }
+
+    template <typename Callable>
+    auto submit(Callable&& task) -> std::future<std::invoke_result_t<std::decay_t<Callable>>> {
+        using Result = std::invoke_result_t<std::decay_t<Callable>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Callable>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        m_wake.notify_one();
+        return result;
+    }
+
+private:
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty()) return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+};
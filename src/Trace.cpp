@@ -0,0 +1,120 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::s_enabled{false};
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    int64_t begin;
+    int64_t end;
+};
+
+// One per thread that has recorded a span. Buffers are owned by the registry
+// so events survive their thread; the mutex is only contended while Stop
+// copies the events out.
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    uint32_t tid = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::string path;
+    int64_t origin = 0;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = r.buffers.back().get();
+        buffer->tid = static_cast<uint32_t>(r.buffers.size());
+        buffer->events.reserve(1024);
+    }
+    return *buffer;
+}
+
+// Span names are literals, but keep the JSON valid whatever they contain.
+void writeName(std::FILE* file, const char* name) {
+    for (const char* c = name; *c; ++c) {
+        if (*c == '"' || *c == '\\') std::fputc('\\', file);
+        if (static_cast<unsigned char>(*c) >= 0x20) std::fputc(*c, file);
+    }
+}
+
+}
+
+void Trace::Start(const std::string& path) {
+    Registry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.path = path;
+        r.origin = Now();
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool Trace::StartFromEnvironment() {
+    const char* path = std::getenv("BIBIRBLE_TRACE");
+    if (!path || !*path) return false;
+    Start(path);
+    return true;
+}
+
+int64_t Trace::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::Record(const char* name, int64_t begin, int64_t end) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({name, begin, end});
+}
+
+bool Trace::Stop() {
+    if (!Enabled()) return false;
+    s_enabled.store(false, std::memory_order_relaxed);
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::FILE* file = std::fopen(r.path.c_str(), "wb");
+    if (!file) return false;
+
+    // Complete ("X") events with microsecond timestamps from Start.
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (const auto& buffer : r.buffers) {
+        std::vector<TraceEvent> events;
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            events.swap(buffer->events);
+        }
+        for (const TraceEvent& event : events) {
+            std::fputs(first ? "" : ",\n", file);
+            first = false;
+            std::fputs("{\"name\":\"", file);
+            writeName(file, event.name);
+            std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->tid,
+                         (event.begin - r.origin) / 1000.0, (event.end - event.begin) / 1000.0);
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
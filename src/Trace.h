@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timing spans written as Chrome trace events, viewable in Perfetto
+// or chrome://tracing. Recording is off until Trace::Start; until then a
+// span costs one relaxed atomic load. Each thread appends to its own buffer,
+// and the buffers are merged into one JSON file by Trace::Stop.
+//
+//   void BibleData::buildIndexes() {
+//       TRACE_SCOPE("BibleData::buildIndexes");
+//       ...
+//
+// Span names must be string literals (or otherwise outlive the trace).
+class Trace {
+public:
+    // Starts recording; Stop writes the events to `path`.
+    static void Start(const std::string& path);
+    // Starts recording if BIBIRBLE_TRACE names an output file.
+    static bool StartFromEnvironment();
+    // Writes everything recorded so far and stops recording. Returns false
+    // if the file cannot be written or tracing was never started.
+    static bool Stop();
+
+    static bool Enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    // Nanoseconds on the trace clock.
+    static int64_t Now();
+    static void Record(const char* name, int64_t begin, int64_t end);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : m_name(Trace::Enabled() ? name : nullptr) {
+        if (m_name) m_begin = Trace::Now();
+    }
+    ~TraceSpan() {
+        if (m_name) Trace::Record(m_name, m_begin, Trace::Now());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_begin = 0;
+};
+
+// Records for the lifetime of the object, into `path` or, when that is empty,
+// the file named by BIBIRBLE_TRACE. Tools hold one for the whole of main().
+class TraceSession {
+public:
+    explicit TraceSession(const std::string& path) {
+        if (!path.empty()) {
+            Trace::Start(path);
+        } else {
+            Trace::StartFromEnvironment();
+        }
+    }
+    ~TraceSession() { Trace::Stop(); }
+
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name)
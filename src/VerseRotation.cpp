@@ -0,0 +1,61 @@
+#include "VerseRotation.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+constexpr char kStateTag[] = "bibirble-rotation";
+constexpr int kStateVersion = 1;
+
+}
+
+void VerseRotation::reset(std::size_t verseCount, uint64_t seed) {
+    m_order = FeistelPermutation(verseCount, FeistelPermutation::Mix(seed));
+    m_position = 0;
+}
+
+bool VerseRotation::load(const std::string& path, std::size_t verseCount) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) return false;
+
+    std::istringstream in(line);
+    std::string tag, key;
+    int version = 0;
+    uint64_t count = 0, position = 0;
+    if (!(in >> tag >> version >> count >> key >> position)) return false;
+    if (tag != kStateTag || version != kStateVersion || count != verseCount || position > count) return false;
+    if (key.size() != 16 || key.find_first_not_of("0123456789abcdef") != std::string::npos) return false;
+
+    m_order = FeistelPermutation(count, std::stoull(key, nullptr, 16));
+    m_position = position;
+    return true;
+}
+
+bool VerseRotation::save(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) return false;
+        char key[17];
+        std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(m_order.key()));
+        file << kStateTag << ' ' << kStateVersion << ' ' << m_order.size() << ' ' << key << ' '
+             << m_position << '\n';
+        if (!file) return false;
+    }
+    // rename replaces the target atomically on POSIX; Windows refuses to
+    // overwrite, so fall back to removing it first there.
+    if (std::rename(temporary.c_str(), path.c_str()) == 0) return true;
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+std::size_t VerseRotation::next() {
+    if (m_order.size() == 0) return 0;
+    if (m_position == m_order.size()) {
+        m_order = FeistelPermutation(m_order.size(), FeistelPermutation::Mix(m_order.key()));
+        m_position = 0;
+    }
+    return static_cast<std::size_t>(m_order(m_position++));
+}
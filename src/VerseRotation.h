@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Permutation.h"
+
+// Deals verse indices without repeats: each pass walks a keyed permutation
+// of [0, verseCount) (FeistelPermutation), so every verse comes up once
+// before any comes up again, and the next pass reshuffles with a key derived
+// from the last. The whole state is the verse count, the key and a cursor,
+// saved as one short line so the rotation carries on across sessions.
+class VerseRotation {
+public:
+    // Starts a fresh rotation over `verseCount` verses.
+    void reset(std::size_t verseCount, uint64_t seed);
+    // Restores a rotation saved by save(). Fails if the file is missing or
+    // malformed, or was written for a different verse count.
+    bool load(const std::string& path, std::size_t verseCount);
+    // Writes the state to a temporary file and renames it over `path`, so a
+    // crash never leaves a half-written state behind.
+    bool save(const std::string& path) const;
+
+    std::size_t verseCount() const { return static_cast<std::size_t>(m_order.size()); }
+    // Verses dealt so far in the current pass.
+    std::size_t position() const { return static_cast<std::size_t>(m_position); }
+    std::size_t next();
+
+private:
+    FeistelPermutation m_order;
+    uint64_t m_position = 0;
+};
@@ -0,0 +1,560 @@
+#include "VerseScanner.h"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define BIBIRBLE_SCANNER_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#  define BIBIRBLE_SCANNER_AVX2 1
+#  define BIBIRBLE_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  define BIBIRBLE_SCANNER_AVX2 1
+#  define BIBIRBLE_SCANNER_AVX2_RUNTIME 1
+#  define BIBIRBLE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#if defined(BIBIRBLE_SCANNER_AVX2)
+#  include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace {
+
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline bool isStringSpecial(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+inline bool isWhitespace(unsigned char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Kernels return the first byte at or after `p` that ends a run: a quote,
+// backslash or control character inside a string, or a non-whitespace byte
+// between tokens. They return `end` when the run reaches it.
+struct Kernels {
+    const char* name;
+    const char* (*findStringSpecial)(const char* p, const char* end);
+    const char* (*skipWhitespace)(const char* p, const char* end);
+};
+
+const char* findStringSpecialScalar(const char* p, const char* end) {
+    while (p < end && !isStringSpecial(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+const char* skipWhitespaceScalar(const char* p, const char* end) {
+    while (p < end && isWhitespace(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+#if defined(BIBIRBLE_SCANNER_SSE2)
+
+const char* findStringSpecialSse2(const char* p, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask) return p + countTrailingZeros(mask);
+        p += 16;
+    }
+    return findStringSpecialScalar(p, end);
+}
+
+const char* skipWhitespaceSse2(const char* p, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage), _mm_cmpeq_epi8(chunk, tab)));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+        if (mask) return p + countTrailingZeros(mask);
+        p += 16;
+    }
+    return skipWhitespaceScalar(p, end);
+}
+
+#endif
+
+#if defined(BIBIRBLE_SCANNER_AVX2)
+
+BIBIRBLE_AVX2_TARGET const char* findStringSpecialAvx2(const char* p, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    while (end - p >= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask) return p + countTrailingZeros(mask);
+        p += 32;
+    }
+    return findStringSpecialScalar(p, end);
+}
+
+BIBIRBLE_AVX2_TARGET const char* skipWhitespaceAvx2(const char* p, const char* end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriage = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    while (end - p >= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, newline)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, carriage), _mm256_cmpeq_epi8(chunk, tab)));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        if (mask) return p + countTrailingZeros(mask);
+        p += 32;
+    }
+    return skipWhitespaceScalar(p, end);
+}
+
+#endif
+
+Kernels selectKernels() {
+#if defined(BIBIRBLE_SCANNER_AVX2)
+#  if defined(BIBIRBLE_SCANNER_AVX2_RUNTIME)
+    if (__builtin_cpu_supports("avx2"))
+#  endif
+    {
+        return {"avx2", &findStringSpecialAvx2, &skipWhitespaceAvx2};
+    }
+#endif
+#if defined(BIBIRBLE_SCANNER_SSE2)
+    return {"sse2", &findStringSpecialSse2, &skipWhitespaceSse2};
+#else
+    return {"scalar", &findStringSpecialScalar, &skipWhitespaceScalar};
+#endif
+}
+
+const Kernels& activeKernels() {
+    static const Kernels kernels = selectKernels();
+    return kernels;
+}
+
+// Well-formed UTF-8 per Unicode table 3-7, which is what nlohmann enforces.
+bool validUtf8(const unsigned char* p, const unsigned char* end) {
+    while (p < end) {
+        // ASCII fast path, eight bytes at a time.
+        while (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if (word & 0x8080808080808080ull) break;
+            p += 8;
+        }
+        if (p >= end) break;
+
+        const unsigned char c = *p;
+        if (c < 0x80) {
+            ++p;
+            continue;
+        }
+
+        int length;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            length = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            length = 3;
+            if (c == 0xE0) lo = 0xA0;
+            if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            length = 4;
+            if (c == 0xF0) lo = 0x90;
+            if (c == 0xF4) hi = 0x8F;
+        } else {
+            return false;
+        }
+        if (end - p < length) return false;
+        if (p[1] < lo || p[1] > hi) return false;
+        for (int i = 2; i < length; ++i) {
+            if (p[i] < 0x80 || p[i] > 0xBF) return false;
+        }
+        p += length;
+    }
+    return true;
+}
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+}
+
+enum Field { kTestament, kArea, kBook, kText, kChapter, kVerse, kUnknown, kStringFieldCount = kChapter };
+
+Field classifyKey(std::string_view key) {
+    switch (key.size()) {
+    case 4:
+        if (key == "area") return kArea;
+        if (key == "book") return kBook;
+        if (key == "text") return kText;
+        break;
+    case 5:
+        if (key == "verse") return kVerse;
+        break;
+    case 7:
+        if (key == "chapter") return kChapter;
+        break;
+    case 9:
+        if (key == "testament") return kTestament;
+        break;
+    default:
+        break;
+    }
+    return kUnknown;
+}
+
+class Scanner {
+public:
+    Scanner(const char* data, std::size_t size, VerseStore& store, const ScanProgress& progress)
+        : m_begin(data), m_p(data), m_end(data + size), m_lastReport(data), m_kernels(activeKernels()),
+          m_store(store), m_progress(progress) {}
+
+    bool run() {
+        // nlohmann skips a leading UTF-8 byte order mark; so do we.
+        if (m_end - m_p >= 3 && std::memcmp(m_p, "\xEF\xBB\xBF", 3) == 0) m_p += 3;
+
+        skipWhitespace();
+        if (!consume('[')) return false;
+        skipWhitespace();
+        if (!consume(']')) {
+            for (;;) {
+                if (!parseVerse()) return false;
+                skipWhitespace();
+                if (consume(']')) break;
+                if (!consume(',')) return false;
+                skipWhitespace();
+            }
+        }
+        skipWhitespace();
+        if (m_progress) m_progress(static_cast<std::size_t>(m_p - m_begin));
+        return m_p == m_end;
+    }
+
+private:
+    static constexpr std::size_t kProgressStep = 64 * 1024;
+    static constexpr int kMaxSkipDepth = 512;
+
+    void skipWhitespace() { m_p = m_kernels.skipWhitespace(m_p, m_end); }
+
+    bool consume(char c) {
+        if (m_p < m_end && *m_p == c) {
+            ++m_p;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseVerse() {
+        if (!consume('{')) return false;
+
+        std::string_view strings[kStringFieldCount];
+        int64_t numbers[2] = {0, 0};
+
+        skipWhitespace();
+        if (!consume('}')) {
+            for (;;) {
+                std::string_view key;
+                if (!parseString(key, m_keyScratch)) return false;
+                skipWhitespace();
+                if (!consume(':')) return false;
+                skipWhitespace();
+
+                const Field field = classifyKey(key);
+                if (field < kStringFieldCount) {
+                    if (!parseString(strings[field], m_scratch[field])) return false;
+                } else if (field == kChapter || field == kVerse) {
+                    if (!parseNumber(numbers[field - kChapter])) return false;
+                } else if (!skipValue(0)) {
+                    return false;
+                }
+
+                skipWhitespace();
+                if (consume('}')) break;
+                if (!consume(',')) return false;
+                skipWhitespace();
+            }
+        }
+
+        if (!m_store.append(strings[kTestament], strings[kArea], strings[kBook],
+                            numbers[0], numbers[1], strings[kText])) {
+            return false;
+        }
+
+        if (m_progress && static_cast<std::size_t>(m_p - m_lastReport) >= kProgressStep) {
+            m_lastReport = m_p;
+            m_progress(static_cast<std::size_t>(m_p - m_begin));
+        }
+        return true;
+    }
+
+    // Leaves `out` pointing into the input when the string has no escapes,
+    // otherwise into `scratch`, which holds the decoded bytes.
+    bool parseString(std::string_view& out, std::string& scratch) {
+        if (!consume('"')) return false;
+
+        const char* start = m_p;
+        const char* stop = m_kernels.findStringSpecial(m_p, m_end);
+        if (stop < m_end && *stop == '"') {
+            if (!validUtf8(reinterpret_cast<const unsigned char*>(start), reinterpret_cast<const unsigned char*>(stop))) {
+                return false;
+            }
+            out = std::string_view(start, static_cast<std::size_t>(stop - start));
+            m_p = stop + 1;
+            return true;
+        }
+
+        scratch.clear();
+        for (;;) {
+            if (stop >= m_end) return false;
+            if (!validUtf8(reinterpret_cast<const unsigned char*>(start), reinterpret_cast<const unsigned char*>(stop))) {
+                return false;
+            }
+            scratch.append(start, stop);
+
+            const char c = *stop;
+            if (c == '"') {
+                m_p = stop + 1;
+                out = scratch;
+                return true;
+            }
+            if (c != '\\') return false;  // unescaped control character
+
+            m_p = stop + 1;
+            if (!parseEscape(scratch)) return false;
+            start = m_p;
+            stop = m_kernels.findStringSpecial(m_p, m_end);
+        }
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (m_end - m_p < 4) return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = m_p[i];
+            uint32_t digit;
+            if (c >= '0' && c <= '9') digit = static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') digit = static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') digit = static_cast<uint32_t>(c - 'A' + 10);
+            else return false;
+            value = (value << 4) | digit;
+        }
+        m_p += 4;
+        return true;
+    }
+
+    bool parseEscape(std::string& out) {
+        if (m_p >= m_end) return false;
+        const char c = *m_p++;
+        switch (c) {
+        case '"': out.push_back('"'); return true;
+        case '\\': out.push_back('\\'); return true;
+        case '/': out.push_back('/'); return true;
+        case 'b': out.push_back('\b'); return true;
+        case 'f': out.push_back('\f'); return true;
+        case 'n': out.push_back('\n'); return true;
+        case 'r': out.push_back('\r'); return true;
+        case 't': out.push_back('\t'); return true;
+        case 'u': break;
+        default: return false;
+        }
+
+        uint32_t codepoint;
+        if (!parseHex4(codepoint)) return false;
+        if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) return false;
+        if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+            uint32_t low;
+            if (m_end - m_p < 2 || m_p[0] != '\\' || m_p[1] != 'u') return false;
+            m_p += 2;
+            if (!parseHex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        appendUtf8(out, codepoint);
+        return true;
+    }
+
+    // Validates a JSON number at m_p and returns its extent.
+    bool scanNumber(const char*& start, bool& isInteger) {
+        start = m_p;
+        isInteger = true;
+        consume('-');
+        if (m_p >= m_end) return false;
+        if (*m_p == '0') {
+            ++m_p;
+        } else if (*m_p >= '1' && *m_p <= '9') {
+            while (m_p < m_end && *m_p >= '0' && *m_p <= '9') ++m_p;
+        } else {
+            return false;
+        }
+        if (consume('.')) {
+            isInteger = false;
+            if (m_p >= m_end || *m_p < '0' || *m_p > '9') return false;
+            while (m_p < m_end && *m_p >= '0' && *m_p <= '9') ++m_p;
+        }
+        if (m_p < m_end && (*m_p == 'e' || *m_p == 'E')) {
+            isInteger = false;
+            ++m_p;
+            if (!consume('+')) consume('-');
+            if (m_p >= m_end || *m_p < '0' || *m_p > '9') return false;
+            while (m_p < m_end && *m_p >= '0' && *m_p <= '9') ++m_p;
+        }
+        return true;
+    }
+
+    // Converts like nlohmann: int64 for negatives, uint64 otherwise, double
+    // when the value has a fraction/exponent or overflows; then cast to int.
+    // Out-of-range values saturate, so VerseStore::append rejects them
+    // rather than seeing a wrapped-around number.
+    bool parseNumber(int64_t& out) {
+        const char* start;
+        bool isInteger;
+        if (!scanNumber(start, isInteger)) return false;
+
+        if (isInteger) {
+            if (*start == '-') {
+                int64_t value;
+                const auto result = std::from_chars(start, m_p, value);
+                if (result.ec == std::errc() && result.ptr == m_p) {
+                    out = value;
+                    return true;
+                }
+            } else {
+                uint64_t value;
+                const auto result = std::from_chars(start, m_p, value);
+                if (result.ec == std::errc() && result.ptr == m_p) {
+                    out = SaturateToInt64(value);
+                    return true;
+                }
+            }
+        }
+
+        std::istringstream in(std::string(start, m_p));
+        in.imbue(std::locale::classic());
+        double value = 0;
+        in >> value;
+        out = SaturateToInt64(value);
+        return true;
+    }
+
+    bool consumeLiteral(const char* literal, std::size_t length) {
+        if (static_cast<std::size_t>(m_end - m_p) < length || std::memcmp(m_p, literal, length) != 0) {
+            return false;
+        }
+        m_p += length;
+        return true;
+    }
+
+    // Skips any JSON value; only reached for keys outside the schema.
+    bool skipValue(int depth) {
+        if (m_p >= m_end || depth > kMaxSkipDepth) return false;
+        switch (*m_p) {
+        case '"': {
+            std::string_view ignored;
+            return parseString(ignored, m_skipScratch);
+        }
+        case '{':
+            ++m_p;
+            skipWhitespace();
+            if (consume('}')) return true;
+            for (;;) {
+                std::string_view ignored;
+                if (!parseString(ignored, m_skipScratch)) return false;
+                skipWhitespace();
+                if (!consume(':')) return false;
+                skipWhitespace();
+                if (!skipValue(depth + 1)) return false;
+                skipWhitespace();
+                if (consume('}')) return true;
+                if (!consume(',')) return false;
+                skipWhitespace();
+            }
+        case '[':
+            ++m_p;
+            skipWhitespace();
+            if (consume(']')) return true;
+            for (;;) {
+                if (!skipValue(depth + 1)) return false;
+                skipWhitespace();
+                if (consume(']')) return true;
+                if (!consume(',')) return false;
+                skipWhitespace();
+            }
+        case 't': return consumeLiteral("true", 4);
+        case 'f': return consumeLiteral("false", 5);
+        case 'n': return consumeLiteral("null", 4);
+        default: {
+            const char* start;
+            bool isInteger;
+            return scanNumber(start, isInteger);
+        }
+        }
+    }
+
+    const char* m_begin;
+    const char* m_p;
+    const char* m_end;
+    const char* m_lastReport;
+    const Kernels& m_kernels;
+    VerseStore& m_store;
+    const ScanProgress& m_progress;
+
+    std::string m_scratch[kStringFieldCount];
+    std::string m_keyScratch;
+    std::string m_skipScratch;
+};
+
+}
+
+bool ScanVerseJson(const char* data, std::size_t size, VerseStore& store, const ScanProgress& progress) {
+    if (!data || size == 0) return false;
+    Scanner scanner(data, size, store, progress);
+    return scanner.run();
+}
+
+const char* VerseScannerKernel() {
+    return activeKernels().name;
+}
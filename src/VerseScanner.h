@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include "VerseStore.h"
+
+// Receives the number of input bytes consumed so far.
+using ScanProgress = std::function<void(std::size_t consumed)>;
+
+// Parser specialised for the bible_sections.json schema: a top-level array of
+// flat objects with testament/area/book/text strings and chapter/verse
+// numbers. It accepts the same documents nlohmann::json does for that schema
+// and yields the same rows as the SAX and DOM loaders, but finds string and
+// whitespace boundaries 16 or 32 bytes at a time (SSE2/AVX2, scalar elsewhere),
+// decodes numbers in place and takes unescaped strings as views of `data`.
+bool ScanVerseJson(const char* data, std::size_t size, VerseStore& store,
+                   const ScanProgress& progress = ScanProgress());
+
+// Name of the scanning kernel selected for this CPU: "avx2", "sse2" or "scalar".
+const char* VerseScannerKernel();
@@ -0,0 +1,240 @@
+#include "VerseStore.h"
+#include <limits>
+#include <utility>
+
+VerseStore::VerseStore(VerseStore&& other) noexcept {
+    *this = std::move(other);
+}
+
+VerseStore& VerseStore::operator=(VerseStore&& other) noexcept {
+    if (this == &other) return *this;
+
+    m_size = other.m_size;
+    m_attached = other.m_attached;
+    m_books = other.m_books;
+    m_areas = other.m_areas;
+    m_testaments = other.m_testaments;
+    m_chapters = other.m_chapters;
+    m_verses = other.m_verses;
+    m_difficulty = other.m_difficulty;
+    m_textOffsets = other.m_textOffsets;
+    m_wordIndex = other.m_wordIndex;
+    m_wordSpans = other.m_wordSpans;
+    m_text = other.m_text;
+    m_ownBooks = std::move(other.m_ownBooks);
+    m_ownAreas = std::move(other.m_ownAreas);
+    m_ownTestaments = std::move(other.m_ownTestaments);
+    m_ownChapters = std::move(other.m_ownChapters);
+    m_ownVerses = std::move(other.m_ownVerses);
+    m_ownDifficulty = std::move(other.m_ownDifficulty);
+    m_ownTextOffsets = std::move(other.m_ownTextOffsets);
+    m_ownWordIndex = std::move(other.m_ownWordIndex);
+    m_ownWordSpans = std::move(other.m_ownWordSpans);
+    m_ownText = std::move(other.m_ownText);
+    m_bookNames = std::move(other.m_bookNames);
+    m_areaNames = std::move(other.m_areaNames);
+    m_testamentNames = std::move(other.m_testamentNames);
+    m_bookByCanonical = other.m_bookByCanonical;
+    m_canonicalBooks = std::move(other.m_canonicalBooks);
+    m_guessAreas = std::move(other.m_guessAreas);
+
+    // A moved std::string may have lived in its small buffer, so owned
+    // columns are re-pointed rather than trusted.
+    if (!m_attached) syncColumns();
+    other.clear();
+    return *this;
+}
+
+void VerseStore::clear() {
+    m_size = 0;
+    m_attached = false;
+    m_ownBooks.clear();
+    m_ownAreas.clear();
+    m_ownTestaments.clear();
+    m_ownChapters.clear();
+    m_ownVerses.clear();
+    m_ownDifficulty.clear();
+    m_ownTextOffsets.clear();
+    m_ownWordIndex.clear();
+    m_ownWordSpans.clear();
+    m_ownText.clear();
+    m_bookNames.clear();
+    m_areaNames.clear();
+    m_testamentNames.clear();
+    syncColumns();
+    syncBookTables();
+}
+
+void VerseStore::reserve(std::size_t verseCount, std::size_t textBytes) {
+    m_ownBooks.reserve(verseCount);
+    m_ownAreas.reserve(verseCount);
+    m_ownTestaments.reserve(verseCount);
+    m_ownChapters.reserve(verseCount);
+    m_ownVerses.reserve(verseCount);
+    m_ownTextOffsets.reserve(verseCount + 1);
+    m_ownWordIndex.reserve(verseCount + 1);
+    // English verse text averages a little under six bytes per word.
+    m_ownWordSpans.reserve(textBytes / 5);
+    m_ownText.reserve(textBytes);
+    syncColumns();
+}
+
+uint8_t VerseStore::find(const std::vector<std::string>& names, std::string_view name) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return static_cast<uint8_t>(i);
+    }
+    return kNoLabel;
+}
+
+bool VerseStore::intern(std::vector<std::string>& names, std::string_view name, uint8_t& id) {
+    // Verses arrive grouped by book, so the most recently added name is the
+    // likeliest hit; search from the back.
+    for (std::size_t i = names.size(); i-- > 0;) {
+        if (names[i] == name) {
+            id = static_cast<uint8_t>(i);
+            return true;
+        }
+    }
+    if (names.size() >= kNoLabel) return false;
+    id = static_cast<uint8_t>(names.size());
+    names.emplace_back(name);
+    return true;
+}
+
+bool VerseStore::append(std::string_view testament, std::string_view area, std::string_view book,
+                        int64_t chapter, int64_t verse, std::string_view text) {
+    if (m_attached) clear();
+    constexpr int64_t kMaxNumber = std::numeric_limits<uint16_t>::max();
+    if (chapter < 0 || chapter > kMaxNumber || verse < 0 || verse > kMaxNumber) return false;
+    if (m_ownText.size() + text.size() > std::numeric_limits<uint32_t>::max()) return false;
+    // Also bounds every word span below, which are 16-bit offsets into the text.
+    if (text.size() > std::numeric_limits<uint16_t>::max()) return false;
+
+    uint8_t testamentId, areaId, bookId;
+    const std::size_t labels = m_areaNames.size() + m_bookNames.size();
+    if (!intern(m_testamentNames, testament, testamentId)) return false;
+    if (!intern(m_areaNames, area, areaId)) return false;
+    if (!intern(m_bookNames, book, bookId)) return false;
+    if (m_areaNames.size() + m_bookNames.size() != labels) syncBookTables();
+
+    if (m_ownTextOffsets.empty()) m_ownTextOffsets.push_back(0);
+    if (m_ownWordIndex.empty()) m_ownWordIndex.push_back(0);
+    m_ownBooks.push_back(bookId);
+    m_ownAreas.push_back(areaId);
+    m_ownTestaments.push_back(testamentId);
+    m_ownDifficulty.clear();
+    m_ownChapters.push_back(static_cast<uint16_t>(chapter));
+    m_ownVerses.push_back(static_cast<uint16_t>(verse));
+    m_ownText.append(text.data(), text.size());
+    m_ownTextOffsets.push_back(static_cast<uint32_t>(m_ownText.size()));
+    appendWordSpans(text);
+    m_ownWordIndex.push_back(static_cast<uint32_t>(m_ownWordSpans.size()));
+    ++m_size;
+    syncColumns();
+    return true;
+}
+
+void VerseStore::appendWordSpans(std::string_view text) {
+    // Same separators as operator>> in the classic locale.
+    auto isSpace = [](char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    };
+    const std::size_t length = text.size();
+    std::size_t i = 0;
+    while (true) {
+        while (i < length && isSpace(text[i])) ++i;
+        if (i == length) break;
+        const std::size_t begin = i;
+        while (i < length && !isSpace(text[i])) ++i;
+        m_ownWordSpans.push_back({static_cast<uint16_t>(begin), static_cast<uint16_t>(i)});
+    }
+}
+
+void VerseStore::attach(const CorpusView& view) {
+    clear();
+    const CorpusHeader& header = *view.header;
+    for (uint32_t i = 0; i < header.bookCount; ++i) {
+        m_bookNames.push_back(view.bookName(static_cast<uint8_t>(i)));
+    }
+    for (uint32_t i = 0; i < header.areaCount; ++i) {
+        m_areaNames.push_back(view.areaName(static_cast<uint8_t>(i)));
+    }
+    for (uint32_t i = 0; i < header.testamentCount; ++i) {
+        m_testamentNames.push_back(view.testamentName(static_cast<uint8_t>(i)));
+    }
+
+    m_attached = true;
+    m_size = view.verseCount();
+    m_books = view.books;
+    m_areas = view.areas;
+    m_testaments = view.testaments;
+    m_chapters = view.chapters;
+    m_verses = view.verses;
+    m_difficulty = view.difficulty;
+    m_textOffsets = view.textOffsets;
+    m_wordIndex = view.wordIndex;
+    m_wordSpans = view.wordSpans;
+    m_text = view.strings;
+    syncBookTables();
+}
+
+void VerseStore::syncBookTables() {
+    m_bookByCanonical.fill(kNoLabel);
+    m_canonicalBooks.assign(m_bookNames.size(), kNoBook);
+    m_guessAreas.assign(m_bookNames.size(), kNoLabel);
+    for (std::size_t b = 0; b < m_bookNames.size(); ++b) {
+        const uint8_t canonical = FindBookId(m_bookNames[b]);
+        if (canonical == kNoBook) continue;
+        m_canonicalBooks[b] = canonical;
+        if (m_bookByCanonical[canonical] == kNoLabel) m_bookByCanonical[canonical] = static_cast<uint8_t>(b);
+        m_guessAreas[b] = find(m_areaNames, kAreaNames[kBooks[canonical].area]);
+    }
+}
+
+void VerseStore::setDifficulty(std::vector<uint16_t> scores) {
+    if (m_attached || scores.size() != m_size) return;
+    m_ownDifficulty = std::move(scores);
+    syncColumns();
+}
+
+void VerseStore::shrinkToFit() {
+    if (m_attached) return;
+    m_ownBooks.shrink_to_fit();
+    m_ownAreas.shrink_to_fit();
+    m_ownTestaments.shrink_to_fit();
+    m_ownChapters.shrink_to_fit();
+    m_ownVerses.shrink_to_fit();
+    m_ownTextOffsets.shrink_to_fit();
+    m_ownWordIndex.shrink_to_fit();
+    m_ownWordSpans.shrink_to_fit();
+    m_ownText.shrink_to_fit();
+    syncColumns();
+}
+
+bool VerseStore::sameContents(const VerseStore& other) const {
+    if (m_size != other.m_size) return false;
+    for (std::size_t i = 0; i < m_size; ++i) {
+        if (m_bookNames[bookId(i)] != other.m_bookNames[other.bookId(i)] ||
+            m_areaNames[areaId(i)] != other.m_areaNames[other.areaId(i)] ||
+            m_testamentNames[testamentId(i)] != other.m_testamentNames[other.testamentId(i)] ||
+            chapter(i) != other.chapter(i) || verse(i) != other.verse(i) ||
+            text(i) != other.text(i)) {
+            return false;
+        }
+        if (hasDifficulty() && other.hasDifficulty() && difficulty(i) != other.difficulty(i)) return false;
+    }
+    return true;
+}
+
+void VerseStore::syncColumns() {
+    m_books = m_ownBooks.data();
+    m_areas = m_ownAreas.data();
+    m_testaments = m_ownTestaments.data();
+    m_chapters = m_ownChapters.data();
+    m_verses = m_ownVerses.data();
+    m_difficulty = m_ownDifficulty.empty() ? nullptr : m_ownDifficulty.data();
+    m_textOffsets = m_ownTextOffsets.data();
+    m_wordIndex = m_ownWordIndex.data();
+    m_wordSpans = m_ownWordSpans.data();
+    m_text = m_ownText.data();
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BookTable.h"
+#include "CorpusFormat.h"
+
+// Chapter and verse numbers from JSON, saturated rather than wrapped so that
+// VerseStore::append rejects anything out of range.
+inline int64_t SaturateToInt64(uint64_t value) {
+    constexpr uint64_t kMax = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    return static_cast<int64_t>(value < kMax ? value : kMax);
+}
+inline int64_t SaturateToInt64(double value) {
+    if (!(value > -9.2e18)) return std::numeric_limits<int64_t>::min();
+    if (value > 9.2e18) return std::numeric_limits<int64_t>::max();
+    return static_cast<int64_t>(value);
+}
+
+// Column-oriented verse storage. Testament, area and book names are interned
+// into small tables and referenced by uint8 ids; all verse text lives in one
+// contiguous arena addressed by offsets, alongside the byte spans of its
+// whitespace-delimited words. The columns either own their memory
+// (JSON loads) or point straight into a mapped binary corpus.
+class VerseStore {
+public:
+    VerseStore() { m_bookByCanonical.fill(kNoLabel); }
+    VerseStore(const VerseStore&) = delete;
+    VerseStore& operator=(const VerseStore&) = delete;
+    VerseStore(VerseStore&& other) noexcept;
+    VerseStore& operator=(VerseStore&& other) noexcept;
+
+    void clear();
+    void reserve(std::size_t verseCount, std::size_t textBytes);
+    // Returns false once an id table runs out of ids (see kNoLabel), when a
+    // chapter or verse number is outside 0..65535, or when a verse exceeds the
+    // 64 KiB that CorpusWordSpan can address.
+    bool append(std::string_view testament, std::string_view area, std::string_view book,
+                int64_t chapter, int64_t verse, std::string_view text);
+    // Adopts the columns of a validated binary corpus without copying them.
+    void attach(const CorpusView& view);
+    // Releases spare capacity after the last append.
+    void shrinkToFit();
+    // Per-verse difficulty scores (Difficulty.h). They depend on the whole
+    // corpus, so they are set after the last append, and append drops them.
+    void setDifficulty(std::vector<uint16_t> scores);
+    bool hasDifficulty() const { return m_difficulty != nullptr; }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    uint8_t bookId(std::size_t index) const { return m_books[index]; }
+    uint8_t areaId(std::size_t index) const { return m_areas[index]; }
+    uint8_t testamentId(std::size_t index) const { return m_testaments[index]; }
+    uint16_t chapter(std::size_t index) const { return m_chapters[index]; }
+    uint16_t verse(std::size_t index) const { return m_verses[index]; }
+    uint16_t difficulty(std::size_t index) const { return m_difficulty[index]; }
+    // Id of `name` in the corresponding table, or kNoLabel. Canonical book
+    // names (BookTable.h) resolve through the perfect hash and an array.
+    uint8_t findBook(std::string_view name) const {
+        const uint8_t canonical = FindBookId(name);
+        return canonical != kNoBook ? m_bookByCanonical[canonical] : find(m_bookNames, name);
+    }
+    uint8_t findArea(std::string_view name) const { return find(m_areaNames, name); }
+    std::string_view text(std::size_t index) const {
+        return std::string_view(m_text + m_textOffsets[index], m_textOffsets[index + 1] - m_textOffsets[index]);
+    }
+
+    // Canonical id (BookTable.h) of book `book`, or kNoBook for a name the
+    // table does not know.
+    uint8_t canonicalBook(uint8_t book) const { return m_canonicalBooks[book]; }
+    // Area id a guess of book `book` is scored with: its canonical area, or
+    // kNoLabel when the book or its area is not in this store.
+    uint8_t guessArea(uint8_t book) const { return m_guessAreas[book]; }
+
+    std::size_t wordCount(std::size_t index) const { return m_wordIndex[index + 1] - m_wordIndex[index]; }
+    // Word spans of verse `index`, relative to the start of text(index).
+    const CorpusWordSpan* wordSpans(std::size_t index) const { return m_wordSpans + m_wordIndex[index]; }
+
+    // Row-by-row comparison of resolved names, numbers and text.
+    bool sameContents(const VerseStore& other) const;
+
+    const std::vector<std::string>& bookNames() const { return m_bookNames; }
+    const std::vector<std::string>& areaNames() const { return m_areaNames; }
+    const std::vector<std::string>& testamentNames() const { return m_testamentNames; }
+
+private:
+    static uint8_t find(const std::vector<std::string>& names, std::string_view name);
+    static bool intern(std::vector<std::string>& names, std::string_view name, uint8_t& id);
+    void appendWordSpans(std::string_view text);
+    void syncColumns();
+    // Rebuilds the canonical-book and guess-area tables after a label is added.
+    void syncBookTables();
+
+    std::size_t m_size = 0;
+    bool m_attached = false;
+
+    const uint8_t* m_books = nullptr;
+    const uint8_t* m_areas = nullptr;
+    const uint8_t* m_testaments = nullptr;
+    const uint16_t* m_chapters = nullptr;
+    const uint16_t* m_verses = nullptr;
+    const uint16_t* m_difficulty = nullptr;
+    const uint32_t* m_textOffsets = nullptr;
+    const uint32_t* m_wordIndex = nullptr;
+    const CorpusWordSpan* m_wordSpans = nullptr;
+    const char* m_text = nullptr;
+
+    std::vector<uint8_t> m_ownBooks;
+    std::vector<uint8_t> m_ownAreas;
+    std::vector<uint8_t> m_ownTestaments;
+    std::vector<uint16_t> m_ownChapters;
+    std::vector<uint16_t> m_ownVerses;
+    std::vector<uint16_t> m_ownDifficulty;
+    std::vector<uint32_t> m_ownTextOffsets;
+    std::vector<uint32_t> m_ownWordIndex;
+    std::vector<CorpusWordSpan> m_ownWordSpans;
+    std::string m_ownText;
+
+    std::vector<std::string> m_bookNames;
+    std::vector<std::string> m_areaNames;
+    std::vector<std::string> m_testamentNames;
+
+    std::array<uint8_t, kBookCount> m_bookByCanonical;
+    std::vector<uint8_t> m_canonicalBooks;
+    std::vector<uint8_t> m_guessAreas;
+};
@@ -1,13 +1,26 @@
 #include "BibirbleWindow.h"
 #include "loading_dialog.h"
+#include "Trace.h"
+#ifdef BIBIRBLE_EMBED_CORPUS
+#include "EmbeddedCorpus.h"
+#endif
+#include <cstring>
 #include <wx/wx.h>
 
+namespace {
+
+// --data PATH from the command line; empty to search (see ResolveDataFilePath).
+std::string g_dataPath;
+
+}
+
 class BibirbleApp : public wxApp {
 public:
     bool OnInit() override {
-        const std::string dataPath = BibleData::ResolveDataFilePath("bible_sections.json");
+        TRACE_SCOPE("BibirbleApp::OnInit");
+        const std::string dataPath = BibleData::ResolveDataFilePath(g_dataPath);
 
-        // Show a small loading dialog that verifies the presence of bible_sections.json
+        // Load the corpus once behind a progress dialog, then hand it to the main window
         LoadingDialog dlg(nullptr, wxString::FromUTF8(dataPath.c_str()));
         dlg.ShowModal();
         if (!dlg.FoundFile()) {
@@ -16,7 +29,7 @@ public:
                 "Warning", wxOK | wxICON_WARNING);
         }
 
-        BibirbleWindow* frame = new BibirbleWindow(nullptr, dataPath);
+        BibirbleWindow* frame = new BibirbleWindow(nullptr, dlg.TakeData());
         frame->Show();
         return true;
     }
@@ -25,5 +38,24 @@ public:
 wxIMPLEMENT_APP_NO_MAIN(BibirbleApp);
 
 int main(int argc, char* argv[]) {
+    // --data and --trace are taken out before wx sees the command line.
+    std::string tracePath;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            g_dataPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+#ifdef BIBIRBLE_EMBED_CORPUS
+    BibleData::UseEmbeddedCorpus(EmbeddedCorpusData(), EmbeddedCorpusSize());
+#endif
+
+    const TraceSession trace(tracePath);
     return wxEntry(argc, argv);
 }
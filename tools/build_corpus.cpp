@@ -0,0 +1,400 @@
+// Native replacement for tools/sort.py: turns the per-book files in tools/*.json
+// into bible_sections.json (byte-identical to sort.py's output) and
+// bible_sections.bin. Books are ingested in parallel on a thread pool.
+//
+// With --cache-dir, each book's processed sections are kept as a shard named
+// after a content hash of its source file, so a rebuild only re-parses the
+// books that changed and merges the rest from their shards.
+//
+// Usage: bibirble_build_corpus [--input DIR] [--output-dir DIR] [--cache-dir DIR]
+//                              [--jobs N] [--verify]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "BibleData.h"
+#include "CorpusWriter.h"
+#include "ThreadPool.h"
+#include "VerseStore.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Section {
+    int chapter;
+    int verse;
+    std::string text;
+};
+
+struct BookResult {
+    std::string book;
+    std::string testament;
+    std::string area;
+    std::vector<Section> sections;
+    std::string shardName;
+    bool fromCache = false;
+    std::string error;
+};
+
+// Bump whenever processBook's rules change so existing shards are ignored.
+constexpr uint64_t kShardVersion = 1;
+constexpr char kShardMagic[8] = {'B', 'I', 'B', 'S', 'H', 'A', 'R', 'D'};
+
+uint64_t fnv1a64(std::string_view data, uint64_t hash = 14695981039346656037ull) {
+    for (const char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string shardNameFor(const std::string& book, const std::string& contents) {
+    const std::string salt(reinterpret_cast<const char*>(&kShardVersion), sizeof(kShardVersion));
+    std::ostringstream name;
+    name << book << '-' << std::hex << std::setw(16) << std::setfill('0') << fnv1a64(contents, fnv1a64(salt))
+         << ".shard";
+    return name.str();
+}
+
+template <typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readPod(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool readShard(const fs::path& path, std::vector<Section>& sections) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kShardMagic)];
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kShardMagic) ||
+        !readPod(in, count)) {
+        return false;
+    }
+
+    sections.clear();
+    sections.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t chapter, verse;
+        uint32_t length;
+        if (!readPod(in, chapter) || !readPod(in, verse) || !readPod(in, length)) return false;
+        std::string text(length, '\0');
+        if (!in.read(&text[0], length)) return false;
+        sections.push_back({chapter, verse, std::move(text)});
+    }
+    return true;
+}
+
+// Writes through a temporary file so a crashed build never leaves a
+// truncated shard under a valid name.
+bool writeShard(const fs::path& path, const std::vector<Section>& sections) {
+    const fs::path temp = path.string() + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(kShardMagic, sizeof(kShardMagic));
+        writePod(out, static_cast<uint32_t>(sections.size()));
+        for (const auto& section : sections) {
+            writePod(out, static_cast<int32_t>(section.chapter));
+            writePod(out, static_cast<int32_t>(section.verse));
+            writePod(out, static_cast<uint32_t>(section.text.size()));
+            out.write(section.text.data(), static_cast<std::streamsize>(section.text.size()));
+        }
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    return !ec;
+}
+
+// Length of the UTF-8 sequence at `p` if it encodes a character Python's
+// str.isspace() accepts, otherwise 0.
+std::size_t pythonSpaceAt(std::string_view s, std::size_t p) {
+    const unsigned char c = static_cast<unsigned char>(s[p]);
+    if (c == ' ' || (c >= 0x09 && c <= 0x0D) || (c >= 0x1C && c <= 0x1F)) return 1;
+    if (c < 0x80) return 0;
+
+    uint32_t cp = 0;
+    std::size_t length = 0;
+    if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; length = 2; }
+    else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; length = 3; }
+    else return 0;
+    if (p + length > s.size()) return 0;
+    for (std::size_t i = 1; i < length; ++i) cp = (cp << 6) | (static_cast<unsigned char>(s[p + i]) & 0x3F);
+
+    const bool space = cp == 0x85 || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) ||
+                       cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000;
+    return space ? length : 0;
+}
+
+// Python's str.strip() with no arguments, on UTF-8.
+std::string_view pythonStrip(std::string_view s) {
+    std::size_t begin = 0;
+    while (begin < s.size()) {
+        const std::size_t n = pythonSpaceAt(s, begin);
+        if (n == 0) break;
+        begin += n;
+    }
+    std::size_t end = s.size();
+    while (end > begin) {
+        // Step back to the start of the last character.
+        std::size_t start = end - 1;
+        while (start > begin && (static_cast<unsigned char>(s[start]) & 0xC0) == 0x80) --start;
+        if (pythonSpaceAt(s, start) != end - start) break;
+        end = start;
+    }
+    return s.substr(begin, end - begin);
+}
+
+// Mirrors the per-book loop in tools/sort.py, including its quirks: a new
+// section 1 while one is pending discards both, and word counts come from
+// splitting on single spaces, so runs of spaces count as empty words.
+BookResult processBook(const fs::path& path, const fs::path& cacheDir) {
+    BookResult result;
+    result.book = path.stem().string();
+    result.testament = BibleData::getBookTestament(result.book);
+    result.area = BibleData::getBookArea(result.book);
+    if (result.area.empty()) {
+        result.error = "no area defined for book '" + result.book + "'";
+        return result;
+    }
+
+    std::string contents;
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        if (!file) {
+            result.error = "cannot read " + path.string();
+            return result;
+        }
+        contents = buffer.str();
+    }
+
+    if (!cacheDir.empty()) {
+        result.shardName = shardNameFor(result.book, contents);
+        if (readShard(cacheDir / result.shardName, result.sections)) {
+            result.fromCache = true;
+            return result;
+        }
+    }
+
+    try {
+        const nlohmann::json elements = nlohmann::json::parse(contents);
+
+        std::size_t pendingSections = 0;
+        std::string text;
+        for (const auto& element : elements) {
+            if (element.at("type").get<std::string>() != "paragraph text") continue;
+
+            const int chapter = element.at("chapterNumber").get<int>();
+            const int verse = element.at("verseNumber").get<int>();
+            if (element.at("sectionNumber").get<int>() == 1) {
+                if (pendingSections == 0) {
+                    pendingSections = 1;
+                    text = element.at("value").get<std::string>();
+                } else {
+                    pendingSections = 0;
+                    text.clear();
+                }
+            } else {
+                ++pendingSections;
+                text += ' ';
+                text += element.at("value").get<std::string>();
+            }
+
+            const std::string_view stripped = pythonStrip(text);
+            const std::size_t words = std::count(stripped.begin(), stripped.end(), ' ') + 1;
+            if (pendingSections >= 1 && words >= 7 && (chapter < 99 || verse < 99)) {
+                result.sections.push_back({chapter, verse, std::string(stripped)});
+                pendingSections = 0;
+                text.clear();
+            }
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+        return result;
+    }
+
+    std::stable_sort(result.sections.begin(), result.sections.end(), [](const Section& a, const Section& b) {
+        return a.chapter != b.chapter ? a.chapter < b.chapter : a.verse < b.verse;
+    });
+
+    if (!cacheDir.empty() && !writeShard(cacheDir / result.shardName, result.sections)) {
+        std::cerr << "warning: could not cache " << result.shardName << "\n";
+    }
+    return result;
+}
+
+// Drops shards that no current book file maps to (old revisions, removed books).
+void pruneShards(const fs::path& cacheDir, const std::vector<BookResult>& books) {
+    std::vector<std::string> live;
+    for (const auto& book : books) live.push_back(book.shardName);
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(cacheDir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (entry.path().extension() == ".shard" && std::find(live.begin(), live.end(), name) == live.end()) {
+            fs::remove(entry.path(), ec);
+        }
+    }
+}
+
+bool verifyOutputs(const VerseStore& expected, const std::string& jsonPath, const std::string& binPath) {
+    struct Check {
+        const char* name;
+        bool json;
+        JsonLoader loader;
+    };
+    const Check checks[] = {
+        {"binary", false, JsonLoader::Scanner},
+        {"scanner", true, JsonLoader::Scanner},
+        {"sax", true, JsonLoader::Streaming},
+        {"dom", true, JsonLoader::Document},
+    };
+
+    bool ok = true;
+    for (const Check& check : checks) {
+        BibleData data;
+        const bool loaded = check.json ? data.loadJson(jsonPath, check.loader) : data.loadBinary(binPath);
+        const bool same = loaded && data.store().sameContents(expected);
+        std::cout << "verify " << check.name << ": " << (same ? "ok" : "MISMATCH") << "\n";
+        ok = ok && same;
+    }
+    return ok;
+}
+
+int usage() {
+    std::cerr << "Usage: bibirble_build_corpus [--input DIR] [--output-dir DIR] [--cache-dir DIR]"
+                 " [--jobs N] [--verify]\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    fs::path inputDir = "tools";
+    fs::path outputDir = ".";
+    fs::path cacheDir;
+    std::size_t jobs = ThreadPool::DefaultThreadCount();
+    bool verify = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) {
+            inputDir = argv[++i];
+        } else if (arg == "--output-dir" && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--verify") {
+            verify = true;
+        } else {
+            return usage();
+        }
+    }
+
+    const auto startedAt = std::chrono::steady_clock::now();
+
+    std::vector<fs::path> inputs;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(inputDir, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            inputs.push_back(entry.path());
+        }
+    }
+    if (ec || inputs.empty()) {
+        std::cerr << "No book files found in " << inputDir.string() << "\n";
+        return 1;
+    }
+    if (!cacheDir.empty()) {
+        fs::create_directories(cacheDir, ec);
+        if (ec) {
+            std::cerr << "Cannot create cache directory " << cacheDir.string() << "\n";
+            return 1;
+        }
+    }
+    fs::create_directories(outputDir, ec);
+    if (ec) {
+        std::cerr << "Cannot create output directory " << outputDir.string() << "\n";
+        return 1;
+    }
+
+    std::vector<BookResult> books;
+    {
+        ThreadPool pool(std::min(jobs, inputs.size()));
+        std::vector<std::future<BookResult>> pending;
+        for (const auto& path : inputs) {
+            pending.push_back(pool.submit([path, cacheDir]() { return processBook(path, cacheDir); }));
+        }
+        for (auto& future : pending) {
+            books.push_back(future.get());
+        }
+    }
+
+    for (const auto& book : books) {
+        if (!book.error.empty()) {
+            std::cerr << book.book << ": " << book.error << "\n";
+            return 1;
+        }
+    }
+
+    if (!cacheDir.empty()) {
+        pruneShards(cacheDir, books);
+    }
+    const std::size_t rebuilt = std::count_if(books.begin(), books.end(),
+                                              [](const BookResult& book) { return !book.fromCache; });
+
+    // sort.py orders by (book, chapter, verse); each book is already sorted.
+    std::sort(books.begin(), books.end(), [](const BookResult& a, const BookResult& b) { return a.book < b.book; });
+
+    std::size_t verseCount = 0, textBytes = 0;
+    for (const auto& book : books) {
+        verseCount += book.sections.size();
+        for (const auto& section : book.sections) textBytes += section.text.size();
+    }
+
+    VerseStore store;
+    store.reserve(verseCount, textBytes);
+    for (const auto& book : books) {
+        for (const auto& section : book.sections) {
+            if (!store.append(book.testament, book.area, book.book, section.chapter, section.verse, section.text)) {
+                std::cerr << "Corpus exceeds the binary format limits\n";
+                return 1;
+            }
+        }
+    }
+
+    const std::string jsonPath = (outputDir / "bible_sections.json").string();
+    const std::string binPath = (outputDir / "bible_sections.bin").string();
+    if (!WriteCorpusJson(store, jsonPath) || !WriteCorpusBinary(store, binPath)) {
+        std::cerr << "Failed to write " << jsonPath << " / " << binPath << "\n";
+        return 1;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - startedAt;
+    std::cout << "Total sections saved: " << store.size() << " (" << rebuilt << " of " << books.size()
+              << " books processed, " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+              << " ms)\n";
+
+    if (verify && !verifyOutputs(store, jsonPath, binPath)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,260 @@
+// Plays Bibirble over stdin/stdout with the same GameEngine as the window, so
+// scripts and bots can drive games without a display. One command per line,
+// one response line per command:
+//
+//   seed N            -> ok                 reseed the verse generator
+//   difficulty TIER   -> ok                 easy, normal or hard for later games
+//   new [INDEX]       -> started            random verse, or the verse at INDEX
+//   daily [DATE]      -> started            the daily puzzle for today or YYYY-MM-DD
+//   guess BOOK CCVV   -> feedback LETTERS STATUS REMAINING
+//   reveal            -> reveal STAGE TEXT
+//   answer            -> answer BOOK CHAPTER:VERSE INDEX
+//   books             -> books NAME...
+//   lookup BOOK C:V   -> verse BOOK CHAPTER:VERSE INDEX TEXT
+//   near INDEX OFFSET -> verse ...           the verse OFFSET places away in
+//                                            reference order, for context
+//   stats             -> stats GAMES WINS STREAK BEST LOST WON1..WON7
+//   bookstats         -> bookstats NAME:WINS/PLAYS...   books played so far
+//   quit
+//
+// LETTERS is the book then the four digits: g green, y yellow, x gray. STATUS
+// is playing, won or lost, and REMAINING the number of verses still
+// consistent with every guess. Anything wrong yields "error MESSAGE".
+// Output is flushed whenever no further input is buffered, so piped batches
+// run at full speed while an interactive peer sees every reply immediately.
+//
+// Finished games are added to the history in --history DIR (the same files
+// the window keeps), or only counted for this session without it.
+//
+// Built with BIBIRBLE_EMBED_CORPUS, the corpus compiled into the program is
+// used unless --data or BIBIRBLE_DATA names one.
+//
+// Usage: bibirble_cli [--data PATH] [--seed N] [--difficulty TIER] [--history DIR]
+//                     [--trace FILE]
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "BibleData.h"
+#include "DailyPuzzle.h"
+#include "GameEngine.h"
+#include "GameHistory.h"
+#include "Trace.h"
+#ifdef BIBIRBLE_EMBED_CORPUS
+#include "EmbeddedCorpus.h"
+#endif
+
+namespace {
+
+const char* statusName(GameStatus status) {
+    switch (status) {
+    case GameStatus::Won: return "won";
+    case GameStatus::Lost: return "lost";
+    case GameStatus::Playing: break;
+    }
+    return "playing";
+}
+
+// Verse text on one protocol line.
+std::string singleLine(std::string text) {
+    for (char& c : text) {
+        if (c == '\n' || c == '\r') c = ' ';
+    }
+    return text;
+}
+
+class Session {
+public:
+    Session(const BibleData& data, GameHistory& history)
+        : m_data(data), m_engine(data), m_daily(data.verseCount()), m_history(history) {}
+
+    void seed(uint64_t value) { m_engine.seed(value); }
+    void setDifficulty(Difficulty tier) { m_engine.setDifficulty(tier); }
+
+    // Runs one command line; returns false on quit.
+    bool run(const std::string& line, std::ostream& out) {
+        std::istringstream in(line);
+        std::string command;
+        if (!(in >> command)) return true;
+
+        if (command == "quit") return false;
+        if (command == "seed") {
+            unsigned long long value;
+            if (!(in >> value)) return error(out, "seed needs a number");
+            m_engine.seed(value);
+            out << "ok\n";
+        } else if (command == "difficulty") {
+            std::string name;
+            Difficulty tier;
+            if (!(in >> name) || !ParseDifficulty(name, tier)) return error(out, "difficulty is easy, normal or hard");
+            m_engine.setDifficulty(tier);
+            out << "ok\n";
+        } else if (command == "new") {
+            std::size_t index;
+            if (in >> index) {
+                if (index >= m_data.verseCount()) return error(out, "verse index out of range");
+                m_engine.start(index);
+            } else {
+                m_engine.start();
+            }
+            m_dailyGame = false;
+            out << "started\n";
+        } else if (command == "daily") {
+            std::string text;
+            CalendarDate date = Today();
+            if (in >> text && !ParseDate(text, date)) return error(out, "date must be YYYY-MM-DD");
+            m_engine.start(m_daily.verseFor(date));
+            m_dailyGame = true;
+            out << "started\n";
+        } else if (command == "guess") {
+            std::string book, digits;
+            if (!(in >> book >> digits) || digits.size() != 4) return error(out, "usage: guess BOOK CCVV");
+            if (!m_engine.isStarted()) return error(out, "no game");
+            if (m_engine.isOver()) return error(out, "game over");
+            if (m_data.store().findBook(book) == kNoLabel) return error(out, "unknown book " + book);
+            const GuessResult result = m_engine.submit(book, digits);
+            if (m_engine.isOver()) {
+                m_history.record(MakeGameRecord(m_engine, m_data.store(), m_dailyGame,
+                                                static_cast<int32_t>(DaysFromCivil(Today()))));
+            }
+            out << "feedback " << result.text() << ' ' << statusName(m_engine.status()) << ' '
+                << m_engine.remainingCount() << '\n';
+        } else if (command == "reveal") {
+            if (!m_engine.isStarted()) return error(out, "no game");
+            const int stage = m_engine.isOver() ? GameEngine::kRevealStages - 1
+                                                : m_engine.guessCount();
+            out << "reveal " << stage << ' ' << singleLine(m_engine.revealText(stage)) << '\n';
+        } else if (command == "answer") {
+            if (!m_engine.isStarted()) return error(out, "no game");
+            const Verse& target = m_engine.target();
+            out << "answer " << target.book << ' ' << target.chapter << ':' << target.verse << ' '
+                << target.id << '\n';
+        } else if (command == "books") {
+            out << "books";
+            for (const std::string& book : m_data.getAllBooks()) out << ' ' << book;
+            out << '\n';
+        } else if (command == "lookup") {
+            std::string book;
+            int chapter = 0, verse = 0;
+            char colon = 0;
+            if (!(in >> book >> chapter >> colon >> verse) || colon != ':') return error(out, "usage: lookup BOOK C:V");
+            const std::size_t index = m_data.findVerse(book, chapter, verse);
+            if (index == ReferenceIndex::kNoVerse) return error(out, "no such verse");
+            printVerse(out, index);
+        } else if (command == "near") {
+            std::size_t index;
+            long long offset;
+            if (!(in >> index >> offset)) return error(out, "usage: near INDEX OFFSET");
+            if (index >= m_data.verseCount()) return error(out, "verse index out of range");
+            const std::size_t neighbour = m_data.references().neighbour(index, static_cast<std::ptrdiff_t>(offset));
+            if (neighbour == ReferenceIndex::kNoVerse) return error(out, "no such verse");
+            printVerse(out, neighbour);
+        } else if (command == "stats") {
+            const HistoryStats& stats = m_history.stats();
+            out << "stats " << stats.games << ' ' << stats.wins << ' ' << stats.currentStreak << ' '
+                << stats.bestStreak;
+            for (const uint64_t n : stats.guessHistogram) out << ' ' << n;
+            out << '\n';
+        } else if (command == "bookstats") {
+            const HistoryStats& stats = m_history.stats();
+            out << "bookstats";
+            for (std::size_t b = 0; b < stats.books.size() && b < kBookCount; ++b) {
+                if (stats.books[b].plays == 0) continue;
+                out << ' ' << kBooks[b].name << ':' << stats.books[b].wins << '/' << stats.books[b].plays;
+            }
+            out << '\n';
+        } else {
+            return error(out, "unknown command " + command);
+        }
+        return true;
+    }
+
+private:
+    void printVerse(std::ostream& out, std::size_t index) const {
+        const VerseStore& store = m_data.store();
+        out << "verse " << store.bookNames()[store.bookId(index)] << ' ' << store.chapter(index) << ':'
+            << store.verse(index) << ' ' << index << ' ' << singleLine(std::string(store.text(index))) << '\n';
+    }
+
+    static bool error(std::ostream& out, const std::string& message) {
+        out << "error " << message << '\n';
+        return true;
+    }
+
+    const BibleData& m_data;
+    GameEngine m_engine;
+    DailyPuzzle m_daily;
+    bool m_dailyGame = false;
+    GameHistory& m_history;
+};
+
+int usage() {
+    std::cerr << "Usage: bibirble_cli [--data PATH] [--seed N] [--difficulty easy|normal|hard] [--history DIR]"
+                 " [--trace FILE]\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataPath;
+    std::string historyDir;
+    std::string tracePath;
+    bool seeded = false;
+    uint64_t seed = 0;
+    Difficulty tier = Difficulty::Normal;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            dataPath = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (arg == "--difficulty" && i + 1 < argc) {
+            if (!ParseDifficulty(argv[++i], tier)) return usage();
+        } else if (arg == "--history" && i + 1 < argc) {
+            historyDir = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+
+    const TraceSession trace(tracePath);
+#ifdef BIBIRBLE_EMBED_CORPUS
+    BibleData::UseEmbeddedCorpus(EmbeddedCorpusData(), EmbeddedCorpusSize());
+#endif
+    BibleData data;
+    if (!data.loadData(dataPath)) {
+        std::cerr << "Cannot load verse data from " << (dataPath.empty() ? "the default locations" : dataPath) << "\n";
+        return 1;
+    }
+
+    GameHistory history;
+    if (!historyDir.empty() && !history.open(historyDir)) {
+        std::cerr << "Cannot open game history in " << historyDir << "\n";
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    Session session(data, history);
+    if (seeded) session.seed(seed);
+    session.setDifficulty(tier);
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!session.run(line, std::cout)) break;
+        if (std::cin.rdbuf()->in_avail() <= 0) std::cout.flush();
+    }
+    std::cout.flush();
+    history.flush();
+    if (history.writeFailed()) {
+        std::cerr << "Some games could not be written to the history in " << historyDir << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Prints the daily puzzle schedule: one line per day with the date, the
+// verse reference and its index in the store. Every install with the same
+// corpus shows the same schedule.
+//
+// Usage: bibirble_daily [--data PATH] [--from YYYY-MM-DD] [--days N]
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "BibleData.h"
+#include "DailyPuzzle.h"
+
+namespace {
+
+int usage() {
+    std::cerr << "Usage: bibirble_daily [--data PATH] [--from YYYY-MM-DD] [--days N]\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataPath;
+    CalendarDate from = Today();
+    long long days = 7;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            dataPath = argv[++i];
+        } else if (arg == "--from" && i + 1 < argc) {
+            if (!ParseDate(argv[++i], from)) return usage();
+        } else if (arg == "--days" && i + 1 < argc) {
+            days = std::atoll(argv[++i]);
+            if (days < 1) return usage();
+        } else {
+            return usage();
+        }
+    }
+
+    BibleData data;
+    if (!data.loadData(dataPath)) {
+        std::cerr << "Cannot load verse data from " << (dataPath.empty() ? "the default locations" : dataPath) << "\n";
+        return 1;
+    }
+    const VerseStore& store = data.store();
+
+    std::ios::sync_with_stdio(false);
+    const DailyPuzzle daily(store.size());
+    const int64_t first = DaysFromCivil(from);
+    for (int64_t day = first; day < first + days; ++day) {
+        const std::size_t i = daily.verseForDay(day);
+        std::cout << FormatDate(CivilFromDays(day)) << ' ' << store.bookNames()[store.bookId(i)] << ' '
+                  << store.chapter(i) << ':' << store.verse(i) << ' ' << i << '\n';
+    }
+    return 0;
+}
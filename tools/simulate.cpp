@@ -0,0 +1,221 @@
+// Self-play simulator: plays many games with one strategy on all cores and
+// reports win rate, guesses used and feedback distributions per verse and per
+// book. The same seed and game count always give the same report.
+//
+// Usage: bibirble_simulate [--data PATH] [--strategy NAME] [--games N] [--seed N]
+//                          [--difficulty TIER] [--jobs N] [--json FILE]
+//                          [--books-csv FILE] [--verses-csv FILE] [--trace FILE]
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "BibleData.h"
+#include "Simulator.h"
+#include "Trace.h"
+
+namespace {
+
+// Book and digit colour totals over a feedback histogram.
+struct ColourCounts {
+    std::array<uint64_t, 3> book = {};
+    std::array<uint64_t, 3> digits = {};
+};
+
+ColourCounts colourCounts(const BookStats& stats) {
+    ColourCounts counts;
+    for (int f = 0; f < kFeedbackPatterns; ++f) {
+        const uint64_t n = stats.feedback[f];
+        if (n == 0) continue;
+        const GuessResult result = GuessResult::Unpack(static_cast<PackedFeedback>(f));
+        counts.book[static_cast<int>(result.book)] += n;
+        for (const Feedback digit : result.digits) counts.digits[static_cast<int>(digit)] += n;
+    }
+    return counts;
+}
+
+double ratio(uint64_t part, uint64_t whole) {
+    return whole ? static_cast<double>(part) / whole : 0.0;
+}
+
+void printSummary(const SimulationReport& report) {
+    std::cout << report.games << " games, strategy " << report.strategy << ", "
+              << DifficultyName(report.difficulty) << ", seed " << report.seed << ", "
+              << report.threads << " threads, " << std::fixed << std::setprecision(2) << report.seconds << " s ("
+              << std::setprecision(0) << report.games / std::max(report.seconds, 1e-9) << " games/s)\n"
+              << std::setprecision(4) << "win rate " << ratio(report.wins(), report.games) << ", mean guesses "
+              << report.meanGuesses() << "\n";
+    for (std::size_t k = 1; k < report.guessHistogram.size(); ++k) {
+        std::cout << "  won in " << k << ": " << report.guessHistogram[k] << "\n";
+    }
+    std::cout << "  lost: " << report.guessHistogram[0] << "\n";
+}
+
+nlohmann::ordered_json toJson(const SimulationReport& report, const VerseStore& store) {
+    nlohmann::ordered_json root;
+    root["strategy"] = report.strategy;
+    root["games"] = report.games;
+    root["seed"] = report.seed;
+    root["difficulty"] = DifficultyName(report.difficulty);
+    root["threads"] = report.threads;
+    root["seconds"] = report.seconds;
+    root["winRate"] = ratio(report.wins(), report.games);
+    root["meanGuesses"] = report.meanGuesses();
+    root["lost"] = report.guessHistogram[0];
+    root["wonIn"] = std::vector<uint64_t>(report.guessHistogram.begin() + 1, report.guessHistogram.end());
+
+    // Feedback is indexed by the packed code: book + 3 * (d0 + 3*d1 + 9*d2 + 27*d3),
+    // with 0 gray, 1 yellow and 2 green.
+    nlohmann::ordered_json books = nlohmann::ordered_json::array();
+    for (std::size_t b = 0; b < report.books.size(); ++b) {
+        const BookStats& stats = report.books[b];
+        const ColourCounts colours = colourCounts(stats);
+        nlohmann::ordered_json book;
+        book["book"] = store.bookNames()[b];
+        book["plays"] = stats.plays;
+        book["wins"] = stats.wins;
+        book["winRate"] = ratio(stats.wins, stats.plays);
+        book["meanGuesses"] = ratio(stats.guesses, stats.plays);
+        book["bookColours"] = colours.book;
+        book["digitColours"] = colours.digits;
+        book["feedback"] = stats.feedback;
+        books.push_back(std::move(book));
+    }
+    root["books"] = std::move(books);
+
+    nlohmann::ordered_json verses = nlohmann::ordered_json::array();
+    for (std::size_t i = 0; i < report.verses.size(); ++i) {
+        const VerseStats& stats = report.verses[i];
+        if (stats.plays == 0) continue;
+        nlohmann::ordered_json verse;
+        verse["index"] = i;
+        verse["book"] = store.bookNames()[store.bookId(i)];
+        verse["chapter"] = store.chapter(i);
+        verse["verse"] = store.verse(i);
+        verse["plays"] = stats.plays;
+        verse["wins"] = stats.wins;
+        verse["meanGuesses"] = ratio(stats.guesses, stats.plays);
+        verses.push_back(std::move(verse));
+    }
+    root["verses"] = std::move(verses);
+    return root;
+}
+
+void writeBooksCsv(std::ostream& out, const SimulationReport& report, const VerseStore& store) {
+    out << "book,plays,wins,win_rate,mean_guesses,book_gray,book_yellow,book_green,"
+           "digit_gray,digit_yellow,digit_green\n";
+    for (std::size_t b = 0; b < report.books.size(); ++b) {
+        const BookStats& stats = report.books[b];
+        const ColourCounts colours = colourCounts(stats);
+        out << store.bookNames()[b] << ',' << stats.plays << ',' << stats.wins << ','
+            << ratio(stats.wins, stats.plays) << ',' << ratio(stats.guesses, stats.plays);
+        for (const uint64_t n : colours.book) out << ',' << n;
+        for (const uint64_t n : colours.digits) out << ',' << n;
+        out << '\n';
+    }
+}
+
+void writeVersesCsv(std::ostream& out, const SimulationReport& report, const VerseStore& store) {
+    out << "index,book,chapter,verse,plays,wins,win_rate,mean_guesses\n";
+    for (std::size_t i = 0; i < report.verses.size(); ++i) {
+        const VerseStats& stats = report.verses[i];
+        out << i << ',' << store.bookNames()[store.bookId(i)] << ',' << store.chapter(i) << ','
+            << store.verse(i) << ',' << stats.plays << ',' << stats.wins << ','
+            << ratio(stats.wins, stats.plays) << ',' << ratio(stats.guesses, stats.plays) << '\n';
+    }
+}
+
+int usage() {
+    std::cerr << "Usage: bibirble_simulate [--data PATH] [--strategy NAME] [--games N] [--seed N]"
+                 " [--difficulty easy|normal|hard] [--jobs N] [--json FILE] [--books-csv FILE]"
+                 " [--verses-csv FILE] [--trace FILE]\n"
+                 "Strategies:";
+    for (const std::string& name : StrategyNames()) std::cerr << ' ' << name;
+    std::cerr << "\n";
+    return 2;
+}
+
+bool writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+    if (!file) std::cerr << "Cannot write " << path << "\n";
+    return static_cast<bool>(file);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataPath;
+    std::string strategy = "random";
+    uint64_t games = 100000;
+    uint64_t seed = 1;
+    Difficulty tier = Difficulty::Normal;
+    std::size_t jobs = ThreadPool::DefaultThreadCount();
+    std::string jsonPath, booksCsvPath, versesCsvPath, tracePath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            dataPath = argv[++i];
+        } else if (arg == "--strategy" && i + 1 < argc) {
+            strategy = argv[++i];
+        } else if (arg == "--games" && i + 1 < argc) {
+            games = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--difficulty" && i + 1 < argc) {
+            if (!ParseDifficulty(argv[++i], tier)) return usage();
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--books-csv" && i + 1 < argc) {
+            booksCsvPath = argv[++i];
+        } else if (arg == "--verses-csv" && i + 1 < argc) {
+            versesCsvPath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+
+    const TraceSession trace(tracePath);
+    BibleData data;
+    if (!data.loadData(dataPath)) {
+        std::cerr << "Cannot load verse data from " << (dataPath.empty() ? "the default locations" : dataPath) << "\n";
+        return 1;
+    }
+
+    const StrategyFactory factory = MakeStrategyFactory(strategy, data);
+    if (!factory) {
+        std::cerr << "Unknown strategy " << strategy << "\n";
+        return usage();
+    }
+
+    const Simulator simulator(data);
+    const SimulationReport report = simulator.run(strategy, factory, games, seed, tier, jobs);
+    printSummary(report);
+
+    bool ok = true;
+    if (!jsonPath.empty()) {
+        ok = writeFile(jsonPath, toJson(report, data.store()).dump(1) + "\n") && ok;
+    }
+    if (!booksCsvPath.empty()) {
+        std::ostringstream csv;
+        writeBooksCsv(csv, report, data.store());
+        ok = writeFile(booksCsvPath, csv.str()) && ok;
+    }
+    if (!versesCsvPath.empty()) {
+        std::ostringstream csv;
+        writeVersesCsv(csv, report, data.store());
+        ok = writeFile(versesCsvPath, csv.str()) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Replays a game's guesses and feedback and prints the solver's next hint.
+//
+// Each guess is given as BOOK CCVV FEEDBACK, where FEEDBACK has one letter
+// for the book and one per digit: g (green), y (yellow) or x (gray). With no
+// guesses the opening hint is printed; --write-cache stores it for the game.
+//
+// Usage: bibirble_solve [--data PATH] [--jobs N] [--write-cache FILE]
+//                       [--trace FILE] [BOOK CCVV FEEDBACK]...
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BibleData.h"
+#include "CandidateIndex.h"
+#include "Scoring.h"
+#include "Solver.h"
+#include "Trace.h"
+
+namespace {
+
+constexpr std::size_t kListCandidateLimit = 20;
+
+struct Turn {
+    std::string book;
+    std::string digits;
+    std::string feedback;
+};
+
+int usage() {
+    std::cerr << "Usage: bibirble_solve [--data PATH] [--jobs N] [--write-cache FILE]"
+                 " [--trace FILE] [BOOK CCVV FEEDBACK]...\n"
+                 "FEEDBACK is five letters (book, then digits): g green, y yellow, x gray\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataPath;
+    std::string cachePath;
+    std::string tracePath;
+    std::size_t jobs = ThreadPool::DefaultThreadCount();
+    std::vector<Turn> turns;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            dataPath = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--write-cache" && i + 1 < argc) {
+            cachePath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg.rfind("--", 0) != 0 && i + 2 < argc) {
+            turns.push_back({arg, argv[i + 1], argv[i + 2]});
+            i += 2;
+        } else {
+            return usage();
+        }
+    }
+
+    const TraceSession trace(tracePath);
+    BibleData data;
+    if (!data.loadData(dataPath)) {
+        std::cerr << "Cannot load verse data from " << (dataPath.empty() ? "the default locations" : dataPath) << "\n";
+        return 1;
+    }
+    const VerseStore& store = data.store();
+
+    CandidateIndex index;
+    index.build(store);
+    VerseBitset candidates(store.size(), true);
+    for (const Turn& turn : turns) {
+        GuessResult result;
+        if (turn.digits.size() != 4 || !GuessResult::Parse(turn.feedback, result)) {
+            std::cerr << "Bad guess: " << turn.book << ' ' << turn.digits << ' ' << turn.feedback << "\n";
+            return usage();
+        }
+        if (store.findBook(turn.book) == kNoLabel) {
+            std::cerr << "Unknown book " << turn.book << "\n";
+            return 1;
+        }
+        index.narrow(candidates, EncodeGuess(store, turn.book, turn.digits), result.pack());
+    }
+
+    const std::size_t remaining = candidates.count();
+    std::cout << remaining << (remaining == 1 ? " verse remains\n" : " verses remain\n");
+    if (remaining == 0) return 1;
+    if (remaining <= kListCandidateLimit) {
+        candidates.forEach([&](std::size_t i) {
+            std::cout << "  " << store.bookNames()[store.bookId(i)] << ' ' << store.chapter(i) << ':'
+                      << store.verse(i) << "\n";
+        });
+    }
+
+    Solver solver(store, jobs);
+    const auto startedAt = std::chrono::steady_clock::now();
+    const Hint hint = turns.empty() ? solver.firstGuess() : solver.bestGuess(candidates);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startedAt);
+    if (!hint.valid()) {
+        std::cerr << "No hint found\n";
+        return 1;
+    }
+
+    const std::string digits = hint.digitString();
+    std::cout << "hint: " << store.bookNames()[hint.book] << ' ' << digits.substr(0, 2) << ':'
+              << digits.substr(2) << std::fixed << std::setprecision(3) << "  (" << hint.entropy << " bits"
+              << (hint.couldWin ? ", could win" : "") << ", " << elapsed.count() << " ms)\n";
+
+    if (!cachePath.empty()) {
+        if (!turns.empty()) {
+            std::cerr << "--write-cache only applies to the opening hint\n";
+            return usage();
+        }
+        if (!solver.saveFirstGuess(cachePath)) {
+            std::cerr << "Cannot write " << cachePath << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,24 +1,29 @@
 from pathlib import Path
 import json
+import struct
+import re
 dir_path = Path("tools/")
 file_list = list(dir_path.glob("*.json"))
 big_list=[]
 i=0
-OLD_TESTIMENT=["genesis","exodus","leviticus","numbers","deuteronomy","joshua","judges","ruth","1samuel","2samuel","1kings","2kings","1chronicles","2chronicles","ezra","nehemiah","esther","job","psalms","proverbs","ecclesiastes","songofsolomon","isaiah","jeremiah","lamentations","ezekiel","daniel","hosea","joel","amos","obadiah","jonah","micah","nahum","habakkuk","zephaniah","haggai","zechariah","malachi"]
-AREAS={
-    "Torah":OLD_TESTIMENT[0:5],
-    "Historical":["joshua","judges","1samuel","2samuel","1kings","2kings","1chronicles","2chronicles"],
-    "Poems":["psalms","proverbs","ecclesiastes","songofsolomon","lamentations"],
-    "Small stories":["job","esther","jonah","ruth","ezra"],
-    "Prophets Major":["isaiah","jeremiah","ezekiel","daniel"],
-    "Prophets Minor":["hosea","joel","amos","obadiah","micah","nahum","habakkuk","zephaniah","haggai","zechariah","malachi","nehemiah"],
-    "Gospel":["matthew","mark","luke","john"],
-    "Acts from Hebrews":["acts","hebrews"],
-    "Pauls letters":["romans","1corinthians","2corinthians","galatians","ephesians","philippians","colossians","1thessalonians","2thessalonians","1timothy","2timothy","titus","philemon"],
-    "Peter letters":["1peter","2peter"],
-    "James and Jude":["james","jude"],
-    "John Letters and Visions":["1john","2john","3john","revelation"]
-}
+# Book metadata shared with the C++ side (src/BookTable.h); columns are
+# name, display, testament, area, familiarity, chapters
+OLD_TESTIMENT=[]
+AREAS={}
+WELL_KNOWN=[]
+FAMILIAR=[]
+with open(dir_path / "books.tsv", 'r', encoding='utf-8') as f:
+    for row in f:
+        if row.startswith("#") or not row.strip():
+            continue
+        name, display, testament, area, familiarity, chapters=row.rstrip("\n").split("\t")
+        if testament=="Old Testament":
+            OLD_TESTIMENT.append(name)
+        AREAS.setdefault(area, []).append(name)
+        if familiarity=="2":
+            WELL_KNOWN.append(name)
+        elif familiarity=="1":
+            FAMILIAR.append(name)
 for file_path in file_list:
     with open(file_path, 'r', encoding='utf-8') as f:
         book=file_path.stem
@@ -66,8 +71,91 @@ for file_path in file_list:
                     
                 
                     i+=1
+
+# Binary corpus next to the JSON; layout documented in src/CorpusFormat.h
+CORPUS_MAGIC=b"BIBLCORP"
+CORPUS_VERSION=3
+# Same integers as ComputeDifficultyScores in src/Difficulty.cpp
+def difficulty_scores(verses, word_counts):
+    def first_two(value):
+        while value>=100:
+            value//=10
+        return value
+    def digit_code(v):
+        return first_two(v["chapter"])*100+first_two(v["verse"])
+    shared={}
+    for v in verses:
+        shared[digit_code(v)]=shared.get(digit_code(v), 0)+1
+    scores=[]
+    for v, words in zip(verses, word_counts):
+        familiarity=2 if v["book"] in WELL_KNOWN else 1 if v["book"] in FAMILIAR else 0
+        unfamiliar=(2-familiarity)*150
+        shortness=min(max(40-words, 0), 33)*9
+        sharing=min(shared[digit_code(v)].bit_length()-1, 6)
+        scores.append(unfamiliar+shortness+sharing*50)
+    return scores
+
+def write_binary_corpus(verses, path):
+    def intern(values):
+        ids={}
+        for value in values:
+            ids.setdefault(value, len(ids))
+        return ids
+    books=intern(v["book"] for v in verses)
+    areas=intern(v["area"] for v in verses)
+    testaments=intern(v["testament"] for v in verses)
+
+    pool=bytearray()
+    text_offsets=[]
+    word_index=[]
+    word_spans=[]
+    for v in verses:
+        encoded=v["text"].encode("utf-8")
+        text_offsets.append(len(pool))
+        word_index.append(len(word_spans))
+        # words are split on the same ASCII whitespace as C's isspace
+        for match in re.finditer(rb"[^ \t\n\r\x0b\x0c]+", encoded):
+            word_spans.append((match.start(), match.end()))
+        pool+=encoded
+    text_offsets.append(len(pool))
+    word_index.append(len(word_spans))
+    labels=[]
+    for name in list(books)+list(areas)+list(testaments):
+        encoded=name.encode("utf-8")
+        labels.append((len(pool), len(encoded)))
+        pool+=encoded
+
+    sections=[
+        b"".join(struct.pack("<II", o, n) for o, n in labels),
+        bytes(books[v["book"]] for v in verses),
+        bytes(areas[v["area"]] for v in verses),
+        bytes(testaments[v["testament"]] for v in verses),
+        struct.pack("<%dH" % len(verses), *(v["chapter"] for v in verses)),
+        struct.pack("<%dH" % len(verses), *(v["verse"] for v in verses)),
+        struct.pack("<%dH" % len(verses), *difficulty_scores(verses, [word_index[k+1]-word_index[k] for k in range(len(verses))])),
+        struct.pack("<%dI" % len(text_offsets), *text_offsets),
+        struct.pack("<%dI" % len(word_index), *word_index),
+        b"".join(struct.pack("<HH", b, e) for b, e in word_spans),
+        bytes(pool),
+    ]
+    header_size=32+16*len(sections)
+    offset=header_size
+    table=b""
+    body=b""
+    for data in sections:
+        padding=(-offset)%8
+        body+=b"\0"*padding
+        offset+=padding
+        table+=struct.pack("<QQ", offset, len(data))
+        body+=data
+        offset+=len(data)
+    header=CORPUS_MAGIC+struct.pack("<6I", CORPUS_VERSION, len(verses), len(books), len(areas), len(testaments), 0)
+    with open(path, 'wb') as f:
+        f.write(header+table+body)
+
 big_list=sorted(big_list, key=lambda x: (x["book"], x["chapter"], x["verse"]))
 with open("bible_sections.json", 'w', encoding='utf-8') as f:
     json.dump(big_list, f, ensure_ascii=False, indent=4)
+write_binary_corpus(big_list, "bible_sections.bin")
 print(f"Total sections saved: {len(big_list)}")
 # exec(open("stats.py").read()) # Commented out as stats.py is not provided